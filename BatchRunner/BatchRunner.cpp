@@ -0,0 +1,449 @@
+#include "../Core/stdafx.h"
+#include <mutex>
+#include <condition_variable>
+#include "../Core/Console.h"
+#include "../Core/EmuSettings.h"
+#include "../Core/SettingTypes.h"
+#include "../Core/NotificationManager.h"
+#include "../Core/INotificationListener.h"
+#include "../Core/MovieManager.h"
+#include "../Core/BatteryManager.h"
+#include "../Core/Ppu.h"
+#include "../Core/GbPpu.h"
+#include "../Core/Gameboy.h"
+#include "../Core/BaseCartridge.h"
+#include "../Core/CartTypes.h"
+#include "../Core/BenchmarkCounters.h"
+#include "../Utilities/CRC32.h"
+#include "../Utilities/Timer.h"
+#include "../Utilities/VirtualFile.h"
+#include "../Utilities/FolderUtilities.h"
+#include "../Utilities/StringUtilities.h"
+#include "../Utilities/HexUtilities.h"
+
+//Headless batch runner - runs a list of rom/movie jobs on a pool of independent Console instances.
+//No rendering/audio device is registered and emulation runs at maximum speed.
+//Each job outputs a single line of JSON (frame count, frame hashes and timing) to stdout.
+//When built with MESEN_BENCHMARK ("make benchmark"), the time spent in each section of the core is also reported.
+
+struct BatchJob
+{
+	string RomPath;
+	string MoviePath;
+	uint32_t Index;
+};
+
+struct BatchJobResult
+{
+	bool Success = false;
+	uint32_t FrameCount = 0;
+	uint32_t LastFrameHash = 0;
+	uint32_t RunHash = 0;
+	double ElapsedMs = 0;
+	double RunMs = 0;
+	CoprocessorType Coprocessor = CoprocessorType::None;
+
+#ifdef MESEN_BENCHMARK
+	uint64_t SectionTicks[(int)BenchmarkSection::Count] = {};
+	uint64_t SectionCalls[(int)BenchmarkSection::Count] = {};
+	uint64_t TotalTicks = 0;
+#endif
+};
+
+class BatchJobListener : public INotificationListener
+{
+private:
+	Console* _console;
+	uint32_t _maxFrames;
+
+	std::mutex _mutex;
+	std::condition_variable _doneSignal;
+	bool _done = false;
+
+	uint32_t _frameCount = 0;
+	uint32_t _lastFrameHash = 0;
+	uint32_t _runHash = 0;
+	atomic<bool> _waitForMovieEnd;
+
+	Timer _runTimer;
+	double _runMs = 0;
+	BatchJobResult _benchmarkResult;
+
+	uint32_t GetFrameHash()
+	{
+		if(_console->GetSettings()->CheckFlag(EmulationFlags::GameboyMode)) {
+			uint16_t* buffer = _console->GetCartridge()->GetGameboy()->GetPpu()->GetOutputBuffer();
+			return CRC32::GetCRC((uint8_t*)buffer, 256 * 239 * sizeof(uint16_t));
+		} else {
+			shared_ptr<Ppu> ppu = _console->GetPpu();
+			bool highRes = ppu->IsHighResOutput();
+			uint32_t width = highRes ? 512 : 256;
+			uint32_t height = highRes ? 478 : 239;
+			return CRC32::GetCRC((uint8_t*)ppu->GetScreenBuffer(), width * height * sizeof(uint16_t));
+		}
+	}
+
+	void ResetCounters()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_frameCount = 0;
+		_lastFrameHash = 0;
+		_runHash = 0;
+		_runTimer.Reset();
+
+#ifdef MESEN_BENCHMARK
+		_console->GetBenchmarkCounters()->Reset();
+#endif
+	}
+
+	void SaveCounters()
+	{
+		_runMs = _runTimer.GetElapsedMS();
+
+#ifdef MESEN_BENCHMARK
+		BenchmarkCounters* counters = _console->GetBenchmarkCounters();
+		for(int i = 0; i < (int)BenchmarkSection::Count; i++) {
+			_benchmarkResult.SectionTicks[i] = counters->GetTicks((BenchmarkSection)i);
+			_benchmarkResult.SectionCalls[i] = counters->GetCalls((BenchmarkSection)i);
+		}
+		_benchmarkResult.TotalTicks = counters->GetTotalTicks();
+#endif
+	}
+
+public:
+	BatchJobListener(Console* console, uint32_t maxFrames)
+	{
+		_console = console;
+		_maxFrames = maxFrames;
+		_waitForMovieEnd = false;
+	}
+
+	void SetWaitForMovieEnd()
+	{
+		_waitForMovieEnd = true;
+	}
+
+	void ProcessNotification(ConsoleNotificationType type, void* parameter) override
+	{
+		switch(type) {
+			case ConsoleNotificationType::GameLoaded:
+			case ConsoleNotificationType::StateLoaded:
+				//Power cycles and state loads (e.g when a movie starts) restart the count
+				ResetCounters();
+				break;
+
+			case ConsoleNotificationType::PpuFrameDone: {
+				if(_console->IsRunAheadFrame()) {
+					break;
+				}
+
+				std::lock_guard<std::mutex> lock(_mutex);
+				if(_done) {
+					break;
+				}
+
+				_frameCount++;
+				_lastFrameHash = GetFrameHash();
+				_runHash = (_runHash * 0x01000193) ^ _lastFrameHash;
+
+				bool movieEnded = _waitForMovieEnd && !_console->GetMovieManager()->Playing();
+				if(movieEnded || (_maxFrames > 0 && _frameCount >= _maxFrames)) {
+					//Pause the emulation thread, the job's worker thread will stop the console
+					_done = true;
+					SaveCounters();
+					_console->Pause();
+					_doneSignal.notify_all();
+				}
+				break;
+			}
+
+			default:
+				break;
+		}
+	}
+
+	void WaitForEnd()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_doneSignal.wait(lock, [this] { return _done; });
+	}
+
+	void GetResult(BatchJobResult &result)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		result.FrameCount = _frameCount;
+		result.LastFrameHash = _lastFrameHash;
+		result.RunHash = _runHash;
+		result.RunMs = _runMs;
+
+#ifdef MESEN_BENCHMARK
+		memcpy(result.SectionTicks, _benchmarkResult.SectionTicks, sizeof(result.SectionTicks));
+		memcpy(result.SectionCalls, _benchmarkResult.SectionCalls, sizeof(result.SectionCalls));
+		result.TotalTicks = _benchmarkResult.TotalTicks;
+#endif
+	}
+};
+
+class BatchRunner
+{
+private:
+	vector<BatchJob> _jobs;
+	uint32_t _threadCount = 1;
+	uint32_t _frameCount = 0;
+
+	std::mutex _jobLock;
+	size_t _nextJob = 0;
+
+	std::mutex _outputLock;
+
+	BatchJobResult RunJob(BatchJob &job)
+	{
+		BatchJobResult result;
+		Timer timer;
+
+		shared_ptr<Console> console(new Console());
+		console->Initialize();
+
+		EmuSettings* settings = console->GetSettings().get();
+
+		//Run uncapped, without any device, and with a deterministic power-on state
+		EmulationConfig emuCfg = settings->GetEmulationConfig();
+		emuCfg.EmulationSpeed = 0;
+		emuCfg.RunAheadFrames = 0;
+		emuCfg.RamPowerOnState = RamState::AllZeros;
+		settings->SetEmulationConfig(emuCfg);
+
+		PreferencesConfig preferences = settings->GetPreferences();
+		preferences.DisableOsd = true;
+		preferences.ShowDebugInfo = false;
+		preferences.RewindBufferSize = 0;
+		settings->SetPreferences(preferences);
+
+		//Every frame must be rendered for the frame hashes to be reproducible
+		VideoConfig videoCfg = settings->GetVideoConfig();
+		videoCfg.DisableFrameSkipping = true;
+		settings->SetVideoConfig(videoCfg);
+
+		AudioConfig audioCfg = settings->GetAudioConfig();
+		audioCfg.EnableAudio = false;
+		settings->SetAudioConfig(audioCfg);
+
+		bool hasMovie = !job.MoviePath.empty();
+		shared_ptr<BatchJobListener> listener(new BatchJobListener(console.get(), _frameCount));
+		console->GetNotificationManager()->RegisterNotificationListener(listener);
+
+		if(console->LoadRom((VirtualFile)job.RomPath, VirtualFile())) {
+			console->GetBatteryManager()->SetSaveEnabled(false);
+			result.Coprocessor = console->GetRomInfo().Coprocessor;
+			result.Success = true;
+			if(hasMovie) {
+				console->GetMovieManager()->Play((VirtualFile)job.MoviePath);
+				if(console->GetMovieManager()->Playing()) {
+					listener->SetWaitForMovieEnd();
+				} else {
+					result.Success = false;
+				}
+			}
+
+			if(result.Success) {
+				listener->WaitForEnd();
+			}
+			console->Stop(false);
+		}
+
+		listener->GetResult(result);
+		result.ElapsedMs = timer.GetElapsedMS();
+
+		console->Release();
+		return result;
+	}
+
+	static string EscapeJson(string str)
+	{
+		string output;
+		for(char c : str) {
+			if(c == '"' || c == '\\') {
+				output += '\\';
+			}
+			output += c;
+		}
+		return output;
+	}
+
+	void WriteResult(BatchJob &job, BatchJobResult &result)
+	{
+		double fps = result.RunMs > 0 ? result.FrameCount * 1000.0 / result.RunMs : 0;
+
+		std::lock_guard<std::mutex> lock(_outputLock);
+		std::cout << "{\"index\":" << job.Index;
+		std::cout << ",\"rom\":\"" << EscapeJson(job.RomPath) << "\"";
+		std::cout << ",\"movie\":\"" << EscapeJson(job.MoviePath) << "\"";
+		std::cout << ",\"success\":" << (result.Success ? "true" : "false");
+		std::cout << ",\"frames\":" << result.FrameCount;
+		std::cout << ",\"lastFrameHash\":\"" << HexUtilities::ToHex(result.LastFrameHash, true) << "\"";
+		std::cout << ",\"runHash\":\"" << HexUtilities::ToHex(result.RunHash, true) << "\"";
+		std::cout << ",\"timeMs\":" << std::fixed << std::setprecision(2) << result.ElapsedMs;
+		std::cout << ",\"runTimeMs\":" << result.RunMs;
+		std::cout << ",\"fps\":" << fps;
+
+#ifdef MESEN_BENCHMARK
+		//Convert the time stamp counter ticks to milliseconds, based on the total run time
+		static constexpr const char* sectionNames[(int)BenchmarkSection::Count] = { "cpu", "ppu", "spc", "dsp", "dma", "coprocessor" };
+		std::cout << ",\"coprocessor\":\"" << GetCoprocessorName(result.Coprocessor) << "\"";
+		std::cout << ",\"sections\":{";
+		for(int i = 0; i < (int)BenchmarkSection::Count; i++) {
+			double ratio = result.TotalTicks > 0 ? (double)result.SectionTicks[i] / result.TotalTicks : 0;
+			std::cout << (i > 0 ? "," : "") << "\"" << sectionNames[i] << "\":{";
+			std::cout << "\"timeMs\":" << result.RunMs * ratio;
+			std::cout << ",\"percent\":" << ratio * 100;
+			std::cout << ",\"calls\":" << result.SectionCalls[i] << "}";
+		}
+		std::cout << "}";
+#endif
+
+		std::cout << "}" << std::endl;
+	}
+
+	static string GetCoprocessorName(CoprocessorType type)
+	{
+		switch(type) {
+			case CoprocessorType::None: return "None";
+			case CoprocessorType::DSP1: return "DSP1";
+			case CoprocessorType::DSP1B: return "DSP1B";
+			case CoprocessorType::DSP2: return "DSP2";
+			case CoprocessorType::DSP3: return "DSP3";
+			case CoprocessorType::DSP4: return "DSP4";
+			case CoprocessorType::GSU: return "GSU";
+			case CoprocessorType::OBC1: return "OBC1";
+			case CoprocessorType::SA1: return "SA1";
+			case CoprocessorType::SDD1: return "SDD1";
+			case CoprocessorType::RTC: return "RTC";
+			case CoprocessorType::Satellaview: return "Satellaview";
+			case CoprocessorType::SPC7110: return "SPC7110";
+			case CoprocessorType::ST010: return "ST010";
+			case CoprocessorType::ST011: return "ST011";
+			case CoprocessorType::ST018: return "ST018";
+			case CoprocessorType::CX4: return "CX4";
+			case CoprocessorType::Gameboy: return "Gameboy";
+			case CoprocessorType::SGB: return "SGB";
+		}
+		return "";
+	}
+
+	void WorkerThread()
+	{
+		while(true) {
+			BatchJob job;
+			{
+				std::lock_guard<std::mutex> lock(_jobLock);
+				if(_nextJob >= _jobs.size()) {
+					return;
+				}
+				job = _jobs[_nextJob++];
+			}
+
+			BatchJobResult result = RunJob(job);
+			WriteResult(job, result);
+		}
+	}
+
+public:
+	BatchRunner(vector<BatchJob> jobs, uint32_t threadCount, uint32_t frameCount)
+	{
+		_jobs = jobs;
+		_threadCount = std::max<uint32_t>(1, threadCount);
+		_frameCount = frameCount;
+	}
+
+	void Run()
+	{
+		vector<unique_ptr<thread>> threads;
+		for(uint32_t i = 0; i < _threadCount; i++) {
+			threads.push_back(unique_ptr<thread>(new thread(&BatchRunner::WorkerThread, this)));
+		}
+
+		for(unique_ptr<thread> &t : threads) {
+			t->join();
+		}
+	}
+};
+
+static void PrintUsage()
+{
+	std::cerr << "Usage: batchrunner [options] <rom> [<rom> ...]" << std::endl;
+	std::cerr << "  --threads <n>   Number of consoles running in parallel (default: number of cores)" << std::endl;
+	std::cerr << "  --frames <n>    Number of frames to run for each job (default: 600, 0 = until the movie ends)" << std::endl;
+	std::cerr << "  --repeat <n>    Run each job n times (results should have identical hashes)" << std::endl;
+	std::cerr << "  --jobs <file>   Text file containing one job per line: <rom>[|<movie>]" << std::endl;
+	std::cerr << "  --home <folder> Home folder used for firmware/save data (default: ./BatchRunnerHome)" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t threadCount = std::max<uint32_t>(1, std::thread::hardware_concurrency());
+	uint32_t frameCount = 600;
+	uint32_t repeatCount = 1;
+	string homeFolder = "BatchRunnerHome";
+	vector<std::pair<string, string>> jobList;
+
+	for(int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if(arg == "--threads" && hasValue) {
+			threadCount = (uint32_t)std::stoul(argv[++i]);
+		} else if(arg == "--frames" && hasValue) {
+			frameCount = (uint32_t)std::stoul(argv[++i]);
+		} else if(arg == "--repeat" && hasValue) {
+			repeatCount = std::max<uint32_t>(1, (uint32_t)std::stoul(argv[++i]));
+		} else if(arg == "--home" && hasValue) {
+			homeFolder = argv[++i];
+		} else if(arg == "--jobs" && hasValue) {
+			ifstream jobFile(argv[++i]);
+			string line;
+			while(std::getline(jobFile, line)) {
+				if(!line.empty() && line.back() == '\r') {
+					line.pop_back();
+				}
+				if(!line.empty()) {
+					vector<string> parts = StringUtilities::Split(line, '|');
+					jobList.push_back({ parts[0], parts.size() > 1 ? parts[1] : "" });
+				}
+			}
+		} else if(arg.substr(0, 2) == "--") {
+			PrintUsage();
+			return 1;
+		} else {
+			jobList.push_back({ arg, "" });
+		}
+	}
+
+	if(jobList.empty()) {
+		PrintUsage();
+		return 1;
+	}
+
+	if(frameCount == 0) {
+		for(std::pair<string, string> &entry : jobList) {
+			if(entry.second.empty()) {
+				std::cerr << "A frame count is required for jobs without a movie: " << entry.first << std::endl;
+				return 1;
+			}
+		}
+	}
+
+	FolderUtilities::SetHomeFolder(homeFolder);
+
+	vector<BatchJob> jobs;
+	for(uint32_t i = 0; i < repeatCount; i++) {
+		for(std::pair<string, string> &entry : jobList) {
+			jobs.push_back({ entry.first, entry.second, (uint32_t)jobs.size() });
+		}
+	}
+
+	Timer timer;
+	BatchRunner runner(jobs, threadCount, frameCount);
+	runner.Run();
+
+	std::cerr << "Ran " << jobs.size() << " job(s) in " << (uint32_t)timer.GetElapsedMS() << " ms" << std::endl;
+	return 0;
+}
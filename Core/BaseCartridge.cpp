@@ -844,6 +844,7 @@ void BaseCartridge::RunCoprocessors()
 {
 	//These coprocessors are run at the end of the frame, or as needed
 	if(_necDsp) {
+		BENCHMARK_SECTION(BenchmarkSection::Coprocessor);
 		_necDsp->Run();
 	}
 }
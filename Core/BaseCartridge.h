@@ -3,6 +3,7 @@
 #include "IMemoryHandler.h"
 #include "CartTypes.h"
 #include "BaseCoprocessor.h"
+#include "BenchmarkCounters.h"
 #include "../Utilities/ISerializable.h"
 
 class MemoryMappings;
@@ -121,6 +122,7 @@ public:
 	__forceinline void SyncCoprocessors()
 	{
 		if(_needCoprocSync) {
+			BENCHMARK_SECTION(BenchmarkSection::Coprocessor);
 			_coprocessor->Run();
 		}
 	}
@@ -0,0 +1,4 @@
+#include "stdafx.h"
+#include "BenchmarkCounters.h"
+
+thread_local BenchmarkCounters* BenchmarkCounters::_current = nullptr;
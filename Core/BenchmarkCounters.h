@@ -0,0 +1,129 @@
+#pragma once
+#include "stdafx.h"
+#include <chrono>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+	#include <x86intrin.h>
+#endif
+
+enum class BenchmarkSection
+{
+	Cpu = 0, //Main CPU, and anything that isn't part of another section
+	Ppu,
+	Spc,
+	Dsp,
+	Dma,
+	Coprocessor,
+	Count
+};
+
+//Exclusive time counters for each section of the emulation core (only used when MESEN_BENCHMARK is defined)
+//Time spent in a nested section (e.g the PPU catching up during a DMA transfer) is only counted in the innermost section.
+class BenchmarkCounters
+{
+private:
+	static constexpr int SectionCount = (int)BenchmarkSection::Count;
+	static constexpr int MaxDepth = 32;
+
+	//Each console's emulation thread points this to its own counters
+	thread_local static BenchmarkCounters* _current;
+
+	uint64_t _ticks[SectionCount] = {};
+	uint64_t _calls[SectionCount] = {};
+	BenchmarkSection _stack[MaxDepth] = {};
+	int _depth = 1;
+	int _overflow = 0;
+	uint64_t _lastTick = 0;
+
+public:
+	static BenchmarkCounters* GetCurrent() { return _current; }
+	static void SetCurrent(BenchmarkCounters* counters) { _current = counters; }
+
+	static __forceinline uint64_t GetTimestamp()
+	{
+#if defined(_MSC_VER) || defined(__i386__) || defined(__x86_64__)
+		return __rdtsc();
+#else
+		return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+	}
+
+	void Reset()
+	{
+		memset(_ticks, 0, sizeof(_ticks));
+		memset(_calls, 0, sizeof(_calls));
+		_stack[0] = BenchmarkSection::Cpu;
+		_depth = 1;
+		_overflow = 0;
+		_lastTick = GetTimestamp();
+	}
+
+	__forceinline void Enter(BenchmarkSection section)
+	{
+		uint64_t now = GetTimestamp();
+		_ticks[(int)_stack[_depth - 1]] += now - _lastTick;
+		_lastTick = now;
+		_calls[(int)section]++;
+
+		if(_depth < MaxDepth) {
+			_stack[_depth++] = section;
+		} else {
+			_overflow++;
+		}
+	}
+
+	__forceinline void Exit()
+	{
+		uint64_t now = GetTimestamp();
+		_ticks[(int)_stack[_depth - 1]] += now - _lastTick;
+		_lastTick = now;
+
+		if(_overflow > 0) {
+			_overflow--;
+		} else if(_depth > 1) {
+			_depth--;
+		}
+	}
+
+	uint64_t GetTicks(BenchmarkSection section) { return _ticks[(int)section]; }
+	uint64_t GetCalls(BenchmarkSection section) { return _calls[(int)section]; }
+
+	uint64_t GetTotalTicks()
+	{
+		uint64_t total = 0;
+		for(int i = 0; i < SectionCount; i++) {
+			total += _ticks[i];
+		}
+		return total;
+	}
+};
+
+class BenchmarkScope
+{
+private:
+	BenchmarkCounters* _counters;
+
+public:
+	__forceinline BenchmarkScope(BenchmarkSection section)
+	{
+		_counters = BenchmarkCounters::GetCurrent();
+		if(_counters) {
+			_counters->Enter(section);
+		}
+	}
+
+	__forceinline ~BenchmarkScope()
+	{
+		if(_counters) {
+			_counters->Exit();
+		}
+	}
+};
+
+#ifdef MESEN_BENCHMARK
+	#define BENCHMARK_SECTION(section) BenchmarkScope benchmarkScope(section)
+#else
+	#define BENCHMARK_SECTION(section)
+#endif
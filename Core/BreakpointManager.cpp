@@ -36,15 +36,14 @@ void BreakpointManager::SetBreakpoints(Breakpoint breakpoints[], uint32_t count)
 					continue;
 				}
 
-				int curIndex = _breakpoints[i].size();
-				_breakpoints[i].insert(std::make_pair(curIndex, bp));
+				_breakpoints[i].push_back(bp);
 
 				if(bp.HasCondition()) {
 					bool success = true;
 					ExpressionData data = _bpExpEval->GetRpnList(bp.GetCondition(), success);
-					_rpnList[i].insert(std::make_pair(curIndex, success ? data : ExpressionData()));
+					_rpnList[i].push_back(success ? data : ExpressionData());
 				} else {
-					_rpnList[i].insert(std::make_pair(curIndex, ExpressionData()));
+					_rpnList[i].push_back(ExpressionData());
 				}
 				
 				_hasBreakpoint = true;
@@ -52,29 +51,106 @@ void BreakpointManager::SetBreakpoints(Breakpoint breakpoints[], uint32_t count)
 			}
 		}
 	}
+
+	for(int i = 0; i < BreakpointManager::BreakpointTypeCount; i++) {
+		BuildPageIndex(i);
+	}
+}
+
+bool BreakpointManager::GetPageKeyRange(Breakpoint &bp, uint32_t &firstKey, uint32_t &pageCount)
+{
+	if(bp.startAddr < 0) {
+		//Matches any address
+		return false;
+	}
+
+	int32_t endAddr = bp.endAddr == -1 ? bp.startAddr : bp.endAddr;
+	uint32_t firstPage = (uint32_t)bp.startAddr >> 12;
+	pageCount = endAddr >= bp.startAddr ? ((uint32_t)endAddr >> 12) - firstPage + 1 : 0;
+	if(pageCount > PageKeyMask) {
+		return false;
+	}
+
+	if(bp.memoryType <= DebugUtilities::GetLastCpuMemoryType()) {
+		firstKey = GetRelativePageKey(bp.startAddr);
+	} else {
+		firstKey = GetAbsolutePageKey(bp.memoryType, bp.startAddr);
+	}
+	return true;
+}
+
+void BreakpointManager::BuildPageIndex(int bpType)
+{
+	vector<Breakpoint> &breakpoints = _breakpoints[bpType];
+	vector<uint32_t> &offsets = _pageOffsets[bpType];
+	vector<int> &pageBreakpoints = _pageBreakpoints[bpType];
+
+	offsets.clear();
+	pageBreakpoints.clear();
+	_globalBreakpoints[bpType].clear();
+
+	if(breakpoints.empty()) {
+		return;
+	}
+
+	//Count the breakpoints in each page, then fill each page's list (keeps the ids sorted within a page)
+	offsets.resize(PageKeyCount + 1, 0);
+	for(int pass = 0; pass < 2; pass++) {
+		for(size_t i = 0; i < breakpoints.size(); i++) {
+			uint32_t firstKey, pageCount;
+			if(!GetPageKeyRange(breakpoints[i], firstKey, pageCount)) {
+				if(pass == 0) {
+					_globalBreakpoints[bpType].push_back((int)i);
+				}
+				continue;
+			}
+
+			for(uint32_t j = 0; j < pageCount; j++) {
+				uint32_t key = (firstKey & ~PageKeyMask) | ((firstKey + j) & PageKeyMask);
+				if(pass == 0) {
+					offsets[key + 1]++;
+				} else {
+					pageBreakpoints[offsets[key]++] = (int)i;
+				}
+			}
+		}
+
+		if(pass == 0) {
+			for(uint32_t key = 0; key < PageKeyCount; key++) {
+				offsets[key + 1] += offsets[key];
+			}
+			pageBreakpoints.resize(offsets[PageKeyCount]);
+		} else {
+			//Each offset now points to the end of its page, shift them back to the start
+			for(uint32_t key = PageKeyCount; key > 0; key--) {
+				offsets[key] = offsets[key - 1];
+			}
+			offsets[0] = 0;
+		}
+	}
 }
 
 void BreakpointManager::GetBreakpoints(Breakpoint* breakpoints, int& execs, int& reads, int& writes)
 {
-	execs = _breakpoints[static_cast<int>(BreakpointType::Execute)].size();
-	reads = _breakpoints[static_cast<int>(BreakpointType::Read)].size();
-	writes = _breakpoints[static_cast<int>(BreakpointType::Write)].size();
+	execs = (int)_breakpoints[static_cast<int>(BreakpointType::Execute)].size();
+	reads = (int)_breakpoints[static_cast<int>(BreakpointType::Read)].size();
+	writes = (int)_breakpoints[static_cast<int>(BreakpointType::Write)].size();
 
 	if (breakpoints == NULL) {
 		return;
 	}
 
 	int offset = 0;
-	for (auto it = _breakpoints[static_cast<int>(BreakpointType::Execute)].cbegin(); it != _breakpoints[static_cast<int>(BreakpointType::Execute)].cend(); it++) {
-		breakpoints[offset++] = it->second;
+	for(Breakpoint &bp : _breakpoints[static_cast<int>(BreakpointType::Execute)]) {
+		breakpoints[offset++] = bp;
 	}
 
-	for (auto it = _breakpoints[static_cast<int>(BreakpointType::Read)].cbegin(); it != _breakpoints[static_cast<int>(BreakpointType::Read)].cend(); it++) {
-		breakpoints[offset++] = it->second;
+	for(Breakpoint &bp : _breakpoints[static_cast<int>(BreakpointType::Read)]) {
+		breakpoints[offset++] = bp;
 	}
 
-	for (auto it = _breakpoints[static_cast<int>(BreakpointType::Write)].cbegin(); it != _breakpoints[static_cast<int>(BreakpointType::Write)].cend(); it++) {
-		breakpoints[offset++] = it->second;
+	for(Breakpoint &bp : _breakpoints[static_cast<int>(BreakpointType::Write)]) {
+		breakpoints[offset++] = bp;
 	}
 }
 
@@ -96,6 +172,38 @@ BreakpointType BreakpointManager::GetBreakpointType(MemoryOperationType type)
 	}
 }
 
+int BreakpointManager::CheckCandidates(int bpType, int* ids, size_t count, MemoryOperationInfo &operationInfo, AddressInfo &address, DebugState &state, bool &stateCaptured)
+{
+	EvalResultType resultType;
+	for(size_t i = 0; i < count; i++) {
+		int id = ids[i];
+		Breakpoint &bp = _breakpoints[bpType][id];
+		if(!bp.Matches(operationInfo.Address, address)) {
+			continue;
+		}
+
+		if(bp.HasCondition()) {
+			ExpressionData &condition = _rpnList[bpType][id];
+			if(condition.UsesState && !stateCaptured) {
+				//The evaluator only reads the CPU registers and the PPU's position/frame count
+				_debugger->GetState(state, true);
+				stateCaptured = true;
+			}
+			if(!_bpExpEval->Evaluate(condition, state, resultType, operationInfo)) {
+				continue;
+			}
+		}
+
+		if(bp.IsMarked()) {
+			_eventManager->AddEvent(DebugEventType::Breakpoint, operationInfo, id);
+		}
+		if(bp.IsEnabled()) {
+			return id;
+		}
+	}
+	return -1;
+}
+
 int BreakpointManager::InternalCheckBreakpoint(MemoryOperationInfo operationInfo, AddressInfo &address)
 {
 	BreakpointType type = GetBreakpointType(operationInfo.Type);
@@ -104,22 +212,32 @@ int BreakpointManager::InternalCheckBreakpoint(MemoryOperationInfo operationInfo
 		return -1;
 	}
 
+	int bpType = (int)type;
+	vector<uint32_t> &offsets = _pageOffsets[bpType];
+	vector<int> &pageBreakpoints = _pageBreakpoints[bpType];
+	vector<int> &globalBreakpoints = _globalBreakpoints[bpType];
+
 	DebugState state;
-	_debugger->GetState(state, false);
-	EvalResultType resultType;
-	unordered_map<int, Breakpoint> &breakpoints = _breakpoints[(int)type];
-	for (auto it = breakpoints.begin(); it != breakpoints.end(); it++) {
-		if (it->second.Matches(operationInfo.Address, address)) {
-			if (!it->second.HasCondition() || _bpExpEval->Evaluate(_rpnList[(int)type][it->first], state, resultType, operationInfo)) {
-				if (it->second.IsMarked()) {
-					_eventManager->AddEvent(DebugEventType::Breakpoint, operationInfo, it->first);
-				}
-				if (it->second.IsEnabled()) {
-					return it->first;
-				}
-			}
+	bool stateCaptured = false;
+	int id = -1;
+
+	if(!globalBreakpoints.empty()) {
+		id = CheckCandidates(bpType, globalBreakpoints.data(), globalBreakpoints.size(), operationInfo, address, state, stateCaptured);
+	}
+
+	if(id < 0 && !DebugUtilities::IsPpuMemory(address.Type)) {
+		uint32_t key = GetRelativePageKey(operationInfo.Address);
+		if(offsets[key] != offsets[key + 1]) {
+			id = CheckCandidates(bpType, pageBreakpoints.data() + offsets[key], offsets[key + 1] - offsets[key], operationInfo, address, state, stateCaptured);
 		}
 	}
 
-	return -1;
+	if(id < 0 && address.Address >= 0) {
+		uint32_t key = GetAbsolutePageKey(address.Type, address.Address);
+		if(offsets[key] != offsets[key + 1]) {
+			id = CheckCandidates(bpType, pageBreakpoints.data() + offsets[key], offsets[key + 1] - offsets[key], operationInfo, address, state, stateCaptured);
+		}
+	}
+
+	return id;
 }
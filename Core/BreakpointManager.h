@@ -16,18 +16,35 @@ class BreakpointManager
 private:
 	static constexpr int BreakpointTypeCount = 3; //Read, Write, Exec
 
+	//Breakpoints are indexed by 4 KB pages - keys 0x0000-0x0FFF are for CPU (relative) addresses, 0x1000-0x1FFF for absolute addresses
+	//Absolute pages of the different memory types share the same keys, collisions only cause extra calls to Breakpoint::Matches
+	static constexpr uint32_t PageKeyCount = 0x2000;
+	static constexpr uint32_t PageKeyMask = 0xFFF;
+
 	Debugger *_debugger;
 	CpuType _cpuType;
 	IEventManager *_eventManager;
 	
-	unordered_map<int, Breakpoint> _breakpoints[BreakpointTypeCount];
-	unordered_map<int, ExpressionData> _rpnList[BreakpointTypeCount];
+	vector<Breakpoint> _breakpoints[BreakpointTypeCount];
+	vector<ExpressionData> _rpnList[BreakpointTypeCount];
 	bool _hasBreakpoint;
 	bool _hasBreakpointType[BreakpointTypeCount] = {};
 
+	//Breakpoint ids for each page key (_pageOffsets[key] to _pageOffsets[key + 1]), and breakpoints that cover too many pages to be indexed
+	vector<uint32_t> _pageOffsets[BreakpointTypeCount];
+	vector<int> _pageBreakpoints[BreakpointTypeCount];
+	vector<int> _globalBreakpoints[BreakpointTypeCount];
+
 	unique_ptr<ExpressionEvaluator> _bpExpEval;
 
+	static uint32_t GetRelativePageKey(uint32_t addr) { return (addr >> 12) & PageKeyMask; }
+	static uint32_t GetAbsolutePageKey(SnesMemoryType memType, uint32_t addr) { return 0x1000 | (((addr >> 12) + (uint32_t)memType * 0x101) & PageKeyMask); }
+
+	bool GetPageKeyRange(Breakpoint &bp, uint32_t &firstKey, uint32_t &pageCount);
+	void BuildPageIndex(int bpType);
+
 	BreakpointType GetBreakpointType(MemoryOperationType type);
+	int CheckCandidates(int bpType, int* ids, size_t count, MemoryOperationInfo &operationInfo, AddressInfo &address, DebugState &state, bool &stateCaptured);
 	int InternalCheckBreakpoint(MemoryOperationInfo operationInfo, AddressInfo &address);
 
 public:
@@ -50,5 +50,6 @@ public:
 
 		uint8_t Read(uint32_t addr) override;
 		void Write(uint32_t addr, uint8_t value) override;
+		uint8_t* GetDirectReadPointer() override { return nullptr; }
 	};
 };
@@ -4,21 +4,22 @@
 #include "DebugBreakHelper.h"
 #include "Profiler.h"
 
-CallstackManager::CallstackManager(Debugger* debugger)
+CallstackManager::CallstackManager(Debugger* debugger, CpuType cpuType)
 {
 	_debugger = debugger;
-	_profiler.reset(new Profiler(debugger));
+	_profiler.reset(new Profiler(debugger, cpuType));
 }
 
 CallstackManager::~CallstackManager()
 {
 }
 
-void CallstackManager::Push(AddressInfo &src, uint32_t srcAddr, AddressInfo& dest, uint32_t destAddr, AddressInfo& ret, uint32_t returnAddress, StackFrameFlags flags)
+void CallstackManager::Push(uint32_t srcAddr, AddressInfo& dest, uint32_t destAddr, AddressInfo& ret, uint32_t returnAddress, StackFrameFlags flags)
 {
 	if(_callstack.size() >= 511) {
 		//Ensure callstack stays below 512 entries - games can use various tricks that could keep making the callstack grow
 		_callstack.pop_front();
+		_profiler->DropOldestFrame();
 	}
 
 	StackFrameInfo stackFrame;
@@ -63,7 +64,7 @@ void CallstackManager::Pop(AddressInfo& dest, uint32_t destAddress)
 
 		if(!foundMatch) {
 			//Couldn't find a matching frame, replace the current one
-			Push(prevFrame.AbsReturn, returnAddr, dest, destAddress, prevFrame.AbsReturn, returnAddr, StackFrameFlags::None);
+			Push(returnAddr, dest, destAddress, prevFrame.AbsReturn, returnAddr, StackFrameFlags::None);
 		}
 	}
 }
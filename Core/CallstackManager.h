@@ -13,10 +13,10 @@ private:
 	unique_ptr<Profiler> _profiler;
 
 public:
-	CallstackManager(Debugger* debugger);
+	CallstackManager(Debugger* debugger, CpuType cpuType);
 	~CallstackManager();
 
-	void Push(AddressInfo& src, uint32_t srcAddr, AddressInfo& dest, uint32_t destAddr, AddressInfo& ret, uint32_t returnAddress, StackFrameFlags flags);
+	void Push(uint32_t srcAddr, AddressInfo& dest, uint32_t destAddr, AddressInfo& ret, uint32_t returnAddress, StackFrameFlags flags);
 	void Pop(AddressInfo& dest, uint32_t destAddr);
 
 	void GetCallstack(StackFrameInfo* callstackArray, uint32_t &callstackSize);
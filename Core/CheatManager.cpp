@@ -12,10 +12,11 @@ CheatManager::CheatManager(Console* console)
 
 void CheatManager::AddCheat(CheatCode code)
 {
+	code.Address &= 0xFFFFFF;
 	_cheats.push_back(code);
-	_cheatsByAddress.emplace(code.Address, code);
+	InsertCheat(code);
 	_hasCheats = true;
-	_bankHasCheats[code.Address >> 16] = true;
+	_pageHasCheats[code.Address >> 12] = true;
 
 	if(code.Address >= 0x7E0000 && code.Address < 0x7E2000) {
 		//Mirror codes for the first 2kb of workram across all workram mirrors
@@ -30,6 +31,45 @@ void CheatManager::AddCheat(CheatCode code)
 	}
 }
 
+void CheatManager::InsertCheat(CheatCode code)
+{
+	if((_cheatTableCount + 1) * 2 > _cheatTable.size()) {
+		ResizeCheatTable(std::max<uint32_t>(64, (uint32_t)_cheatTable.size() * 2));
+	}
+
+	uint32_t mask = (uint32_t)_cheatTable.size() - 1;
+	for(uint32_t i = GetTableIndex(code.Address); ; i = (i + 1) & mask) {
+		if(_cheatTable[i].Address == code.Address) {
+			//Keep the first code that was added for this address
+			return;
+		} else if(_cheatTable[i].Address == EmptyEntry) {
+			_cheatTable[i] = code;
+			_cheatTableCount++;
+			return;
+		}
+	}
+}
+
+void CheatManager::ResizeCheatTable(uint32_t size)
+{
+	vector<CheatCode> entries;
+	entries.swap(_cheatTable);
+
+	_cheatTable.resize(size, CheatCode { EmptyEntry, 0 });
+	_cheatTableCount = 0;
+	_cheatTableShift = 32;
+	while(size > 1) {
+		_cheatTableShift--;
+		size >>= 1;
+	}
+
+	for(CheatCode &entry : entries) {
+		if(entry.Address != EmptyEntry) {
+			InsertCheat(entry);
+		}
+	}
+}
+
 void CheatManager::SetCheats(vector<CheatCode> codes)
 {
 	auto lock = _console->AcquireLock();
@@ -71,9 +111,11 @@ void CheatManager::ClearCheats(bool showMessage)
 	bool hadCheats = !_cheats.empty();
 
 	_cheats.clear();
-	_cheatsByAddress.clear();
+	_cheatTable.clear();
+	_cheatTableShift = 32;
+	_cheatTableCount = 0;
 	_hasCheats = false;
-	memset(_bankHasCheats, 0, sizeof(_bankHasCheats));
+	memset(_pageHasCheats, 0, sizeof(_pageHasCheats));
 
 	if(showMessage && hadCheats) {
 		MessageManager::DisplayMessage("Cheats", "CheatsDisabled");
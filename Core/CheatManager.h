@@ -13,12 +13,26 @@ class CheatManager
 {
 private:
 	Console* _console;
+	//Address used to mark unused entries in the cheat table (cheat addresses are 24-bit)
+	static constexpr uint32_t EmptyEntry = 0xFFFFFFFF;
+
 	bool _hasCheats = false;
-	bool _bankHasCheats[0x100] = {};
+	bool _pageHasCheats[0x1000] = {};
 	vector<CheatCode> _cheats;
-	unordered_map<uint32_t, CheatCode> _cheatsByAddress;
+
+	//Open addressing hash table (linear probing), always at most half full
+	vector<CheatCode> _cheatTable;
+	uint32_t _cheatTableShift = 32;
+	uint32_t _cheatTableCount = 0;
 	
 	void AddCheat(CheatCode code);
+	void InsertCheat(CheatCode code);
+	void ResizeCheatTable(uint32_t size);
+
+	__forceinline uint32_t GetTableIndex(uint32_t addr)
+	{
+		return (addr * 0x9E3779B1) >> _cheatTableShift;
+	}
 
 public:
 	CheatManager(Console* console);
@@ -36,10 +50,16 @@ public:
 
 __forceinline void CheatManager::ApplyCheat(uint32_t addr, uint8_t &value)
 {
-	if(_hasCheats && _bankHasCheats[addr >> 16]) {
-		auto result = _cheatsByAddress.find(addr);
-		if(result != _cheatsByAddress.end()) {
-			value = result->second.Value;
+	if(_hasCheats && _pageHasCheats[addr >> 12]) {
+		uint32_t mask = (uint32_t)_cheatTable.size() - 1;
+		for(uint32_t i = GetTableIndex(addr); ; i = (i + 1) & mask) {
+			CheatCode &entry = _cheatTable[i];
+			if(entry.Address == addr) {
+				value = entry.Value;
+				return;
+			} else if(entry.Address == EmptyEntry) {
+				return;
+			}
 		}
 	}
 }
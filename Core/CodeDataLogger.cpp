@@ -6,13 +6,14 @@ CodeDataLogger::CodeDataLogger(uint32_t prgSize, CpuType cpuType)
 {
 	_cpuType = cpuType;
 	_prgSize = prgSize;
-	_cdlData = new uint8_t[prgSize];
+	_localData = vector<uint8_t>(prgSize);
+	_cdlData = _localData.data();
+	_changedPages = vector<uint64_t>(((prgSize >> PageShift) >> 6) + 1);
 	Reset();
 }
 
 CodeDataLogger::~CodeDataLogger()
 {
-	delete[] _cdlData;
 }
 
 void CodeDataLogger::Reset()
@@ -20,6 +21,20 @@ void CodeDataLogger::Reset()
 	_codeSize = 0;
 	_dataSize = 0;
 	memset(_cdlData, 0, _prgSize);
+	MarkChanged(0, _prgSize - 1);
+}
+
+void CodeDataLogger::MarkChanged(uint32_t start, uint32_t end)
+{
+	if(start >= _prgSize) {
+		return;
+	}
+
+	_needFlush = true;
+	end = std::min(end, _prgSize - 1);
+	for(uint32_t page = start >> PageShift, last = end >> PageShift; page <= last; page++) {
+		_changedPages[page >> 6] |= (uint64_t)1 << (page & 0x3F);
+	}
 }
 
 uint32_t CodeDataLogger::GetPrgSize()
@@ -29,38 +44,59 @@ uint32_t CodeDataLogger::GetPrgSize()
 
 bool CodeDataLogger::LoadCdlFile(string cdlFilepath, bool autoResetCdl, uint32_t romCrc)
 {
+	vector<uint8_t> cdlData(_cdlData, _cdlData + _prgSize);
+	bool loaded = false;
+
 	VirtualFile cdlFile = cdlFilepath;
 	if(cdlFile.IsValid()) {
 		uint32_t fileSize = (uint32_t)cdlFile.GetSize();
-		vector<uint8_t> cdlData;
-		cdlFile.ReadFile(cdlData);
+		vector<uint8_t> fileData;
+		cdlFile.ReadFile(fileData);
 
 		if(fileSize >= _prgSize) {
-			Reset();
-
-			constexpr int headerSize = 9; //"CDLv2" + 4-byte CRC32 value
-			if(memcmp(cdlData.data(), "CDLv2", 5) == 0) {
-				uint32_t savedCrc = cdlData[5] | (cdlData[6] << 8) | (cdlData[7] << 16) | (cdlData[8] << 24);
-				if((autoResetCdl && savedCrc != romCrc) || fileSize < _prgSize + headerSize) {
-					memset(_cdlData, 0, _prgSize);
-				} else {
-					memcpy(_cdlData, cdlData.data() + headerSize, _prgSize);
+			std::fill(cdlData.begin(), cdlData.end(), 0);
+			if(memcmp(fileData.data(), "CDLv2", 5) == 0) {
+				uint32_t savedCrc = fileData[5] | (fileData[6] << 8) | (fileData[7] << 16) | (fileData[8] << 24);
+				if(!(autoResetCdl && savedCrc != romCrc) && fileSize >= _prgSize + HeaderSize) {
+					memcpy(cdlData.data(), fileData.data() + HeaderSize, _prgSize);
 				}
 			} else {
 				//Older CRC-less CDL file, use as-is without checking CRC to avoid data loss
-				memcpy(_cdlData, cdlData.data(), _prgSize);
+				memcpy(cdlData.data(), fileData.data(), _prgSize);
 			}
-
-			CalculateStats();
-			
-			return true;
+			loaded = true;
 		}
 	}
-	return false;
+
+	//Map the file, so the changes are written to it as the game runs (older files are converted to the current format)
+	_cdlFile.Close();
+	if(_prgSize > 0 && _cdlFile.Open(cdlFilepath, HeaderSize + _prgSize)) {
+		uint8_t* header = _cdlFile.GetData();
+		memcpy(header, "CDLv2", 5);
+		header[5] = romCrc & 0xFF;
+		header[6] = (romCrc >> 8) & 0xFF;
+		header[7] = (romCrc >> 16) & 0xFF;
+		header[8] = (romCrc >> 24) & 0xFF;
+		_cdlData = header + HeaderSize;
+		_cdlFilepath = cdlFilepath;
+		vector<uint8_t>().swap(_localData);
+	}
+
+	memcpy(_cdlData, cdlData.data(), _prgSize);
+	CalculateStats();
+	MarkChanged(0, _prgSize - 1);
+	return loaded;
 }
 
 bool CodeDataLogger::SaveCdlFile(string cdlFilepath, uint32_t romCrc)
 {
+	if(_cdlFile.IsOpen() && cdlFilepath == _cdlFilepath) {
+		//The file is already up to date, just make sure it's written to the disk
+		_cdlFile.Flush(true);
+		_needFlush = false;
+		return true;
+	}
+
 	ofstream cdlFile(cdlFilepath, ios::out | ios::binary);
 	if(cdlFile) {
 		cdlFile.write("CDLv2", 5);
@@ -75,6 +111,14 @@ bool CodeDataLogger::SaveCdlFile(string cdlFilepath, uint32_t romCrc)
 	return false;
 }
 
+void CodeDataLogger::Flush()
+{
+	if(_needFlush && _cdlFile.IsOpen()) {
+		_cdlFile.Flush(false);
+		_needFlush = false;
+	}
+}
+
 void CodeDataLogger::CalculateStats()
 {
 	uint32_t codeSize = 0;
@@ -92,12 +136,29 @@ void CodeDataLogger::CalculateStats()
 	_dataSize = dataSize;
 }
 
+void CodeDataLogger::UpdateStats(uint8_t prevFlags, uint8_t flags)
+{
+	//Same rules as CalculateStats (bytes marked as both code and data count as code)
+	if(prevFlags & CdlFlags::Code) {
+		_codeSize--;
+	} else if(prevFlags & CdlFlags::Data) {
+		_dataSize--;
+	}
+
+	if(flags & CdlFlags::Code) {
+		_codeSize++;
+	} else if(flags & CdlFlags::Data) {
+		_dataSize++;
+	}
+}
+
 void CodeDataLogger::SetFlags(int32_t absoluteAddr, uint8_t flags)
 {
 	if(absoluteAddr >= 0 && absoluteAddr < (int32_t)_prgSize) {
-		if((_cdlData[absoluteAddr] & flags) != flags) {
+		uint8_t prevFlags = _cdlData[absoluteAddr];
+		if((prevFlags & flags) != flags) {
 			if(flags & CdlFlags::Code) {
-				_cdlData[absoluteAddr] = flags | (_cdlData[absoluteAddr] & ~(CdlFlags::Data | CdlFlags::IndexMode8 | CdlFlags::MemoryMode8));
+				_cdlData[absoluteAddr] = flags | (prevFlags & ~(CdlFlags::Data | CdlFlags::IndexMode8 | CdlFlags::MemoryMode8));
 			} else if(flags & CdlFlags::Data) {
 				if(!IsCode(absoluteAddr)) {
 					_cdlData[absoluteAddr] |= flags;
@@ -105,14 +166,14 @@ void CodeDataLogger::SetFlags(int32_t absoluteAddr, uint8_t flags)
 			} else {
 				_cdlData[absoluteAddr] |= flags;
 			}
+			UpdateStats(prevFlags, _cdlData[absoluteAddr]);
+			MarkChanged(absoluteAddr, absoluteAddr);
 		}
 	}
 }
 
 CdlRatios CodeDataLogger::GetRatios()
 {
-	CalculateStats();
-
 	CdlRatios ratios;
 	ratios.CodeRatio = (float)_codeSize / (float)_prgSize;
 	ratios.DataRatio = (float)_dataSize / (float)_prgSize;
@@ -162,6 +223,8 @@ void CodeDataLogger::SetCdlData(uint8_t *cdlData, uint32_t length)
 {
 	if(length <= _prgSize) {
 		memcpy(_cdlData, cdlData, length);
+		CalculateStats();
+		MarkChanged(0, _prgSize - 1);
 	}
 }
 
@@ -178,8 +241,11 @@ uint8_t CodeDataLogger::GetFlags(uint32_t addr)
 void CodeDataLogger::MarkBytesAs(uint32_t start, uint32_t end, uint8_t flags)
 {
 	for(uint32_t i = start; i <= end; i++) {
-		_cdlData[i] = (_cdlData[i] & 0xFC) | (int)flags;
+		uint8_t prevFlags = _cdlData[i];
+		_cdlData[i] = (prevFlags & 0xFC) | (int)flags;
+		UpdateStats(prevFlags, _cdlData[i]);
 	}
+	MarkChanged(start, end);
 }
 
 void CodeDataLogger::StripData(uint8_t* romBuffer, CdlStripOption flag)
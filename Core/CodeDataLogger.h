@@ -1,17 +1,34 @@
 #pragma once
 #include "stdafx.h"
 #include "DebugTypes.h"
+#include "../Utilities/MemoryMappedFile.h"
 
 class CodeDataLogger
 {
 private:
+	static constexpr int HeaderSize = 9; //"CDLv2" + 4-byte CRC32 value
+
+	//Points to the mapped CDL file (after its header) once LoadCdlFile is called, otherwise to _localData
 	uint8_t* _cdlData = nullptr;
+	vector<uint8_t> _localData;
+	MemoryMappedFile _cdlFile;
+	string _cdlFilepath;
+	bool _needFlush = false;
+
 	CpuType _cpuType = CpuType::Cpu;
 	uint32_t _prgSize = 0;
+
+	//Updated as the flags change, so GetRatios doesn't need to scan the data
 	uint32_t _codeSize = 0;
 	uint32_t _dataSize = 0;
+
+	//1 bit per 256-byte page, set when the page's flags change (used by the disassembler to refresh only the affected lines)
+	static constexpr int PageShift = 8;
+	vector<uint64_t> _changedPages;
 	
 	void CalculateStats();
+	void UpdateStats(uint8_t prevFlags, uint8_t flags);
+	void MarkChanged(uint32_t start, uint32_t end);
 
 public:
 	CodeDataLogger(uint32_t prgSize, CpuType cpuType);
@@ -22,6 +39,7 @@ public:
 
 	bool LoadCdlFile(string cdlFilepath, bool autoResetCdl, uint32_t romCrc);
 	bool SaveCdlFile(string cdlFilepath, uint32_t romCrc);
+	void Flush();
 
 	void SetFlags(int32_t absoluteAddr, uint8_t flags);
 
@@ -39,5 +57,24 @@ public:
 	uint8_t GetFlags(uint32_t addr);
 
 	void MarkBytesAs(uint32_t start, uint32_t end, uint8_t flags);
+
+	//Calls callback(start, end) for each page that changed since the last call
+	template<typename T>
+	void ProcessChangedPages(T callback)
+	{
+		for(size_t i = 0; i < _changedPages.size(); i++) {
+			uint64_t changed = _changedPages[i];
+			if(changed) {
+				_changedPages[i] = 0;
+				for(int j = 0; j < 64; j++) {
+					if(changed & ((uint64_t)1 << j)) {
+						uint32_t start = (uint32_t)((i * 64 + j) << PageShift);
+						callback(start, start + (1 << PageShift) - 1);
+					}
+				}
+			}
+		}
+	}
+
 	void StripData(uint8_t* romBuffer, CdlStripOption flag);
 };
\ No newline at end of file
@@ -74,12 +74,14 @@ void Console::Initialize()
 
 	_videoDecoder->StartThread();
 	_videoRenderer->StartThread();
+	_soundMixer->StartThread();
 }
 
 void Console::Release()
 {
 	Stop(true);
 
+	_soundMixer->StopThread();
 	_videoDecoder->StopThread();
 	_videoRenderer->StopThread();
 	
@@ -126,6 +128,10 @@ void Console::Run()
 	_videoDecoder->StartThread();
 	_emulationThreadId = std::this_thread::get_id();
 
+#ifdef MESEN_BENCHMARK
+	BenchmarkCounters::SetCurrent(&_benchmarkCounters);
+#endif
+
 	_memoryManager->IncMasterClockStartup();
 	_controlManager->UpdateInputState();
 
@@ -186,13 +192,16 @@ bool Console::ProcessSystemActions()
 
 void Console::RunFrameWithRunAhead()
 {
-	stringstream runAheadState;
+	if(!_runAheadState) {
+		_runAheadState.reset(new Serializer(SaveStateManager::FileFormatVersion));
+	}
+
 	uint32_t frameCount = _settings->GetEmulationConfig().RunAheadFrames;
 
 	//Run a single frame and save the state (no audio/video)
 	_isRunAheadFrame = true;
 	RunFrame();
-	Serialize(runAheadState, 0);
+	SaveSnapshot(*_runAheadState);
 
 	while(frameCount > 1) {
 		//Run extra frames if the requested run ahead frame count is higher than 1
@@ -209,7 +218,7 @@ void Console::RunFrameWithRunAhead()
 	if(!wasReset) {
 		//Load the state we saved earlier
 		_isRunAheadFrame = true;
-		Deserialize(runAheadState, SaveStateManager::FileFormatVersion, false);
+		LoadSnapshot(*_runAheadState);
 		_isRunAheadFrame = false;
 	}
 }
@@ -318,6 +327,7 @@ void Console::Stop(bool sendNotification)
 	_memoryManager.reset();
 	_dmaController.reset();
 	_msu1.reset();
+	_runAheadState.reset();
 
 	_soundMixer->StopAudio(true);
 
@@ -712,6 +722,12 @@ void Console::WaitForLock()
 void Console::Serialize(ostream &out, int compressionLevel)
 {
 	Serializer serializer(SaveStateManager::FileFormatVersion);
+	Serialize(serializer);
+	serializer.Save(out, compressionLevel);
+}
+
+void Console::Serialize(Serializer &serializer)
+{
 	bool isGameboyMode = _settings->CheckFlag(EmulationFlags::GameboyMode);
 
 	if(!isGameboyMode) {
@@ -730,12 +746,16 @@ void Console::Serialize(ostream &out, int compressionLevel)
 		serializer.Stream(_cart.get());
 		serializer.Stream(_controlManager.get());
 	}
-	serializer.Save(out, compressionLevel);
 }
 
 void Console::Deserialize(istream &in, uint32_t fileFormatVersion, bool compressed)
 {
 	Serializer serializer(in, fileFormatVersion, compressed);
+	Deserialize(serializer);
+}
+
+void Console::Deserialize(Serializer &serializer)
+{
 	bool isGameboyMode = _settings->CheckFlag(EmulationFlags::GameboyMode);
 
 	if(!isGameboyMode) {
@@ -757,6 +777,19 @@ void Console::Deserialize(istream &in, uint32_t fileFormatVersion, bool compress
 	_notificationManager->SendNotification(ConsoleNotificationType::StateLoaded);
 }
 
+void Console::SaveSnapshot(Serializer &snapshot)
+{
+	//Saves an uncompressed state into the snapshot's buffers, which are reused from one call to the next
+	snapshot.ResetForSave();
+	Serialize(snapshot);
+}
+
+void Console::LoadSnapshot(Serializer &snapshot)
+{
+	snapshot.ResetForLoad();
+	Deserialize(snapshot);
+}
+
 shared_ptr<SoundMixer> Console::GetSoundMixer()
 {
 	return _soundMixer;
@@ -885,11 +918,6 @@ void Console::StopDebugger()
 	Unlock();
 }
 
-bool Console::IsDebugging()
-{
-	return _debugger != nullptr;
-}
-
 thread::id Console::GetEmulationThreadId()
 {
 	return _emulationThreadId;
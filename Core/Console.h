@@ -5,6 +5,7 @@
 #include "Debugger.h"
 #include "ConsoleLock.h"
 #include "HistoryViewer.h"
+#include "BenchmarkCounters.h"
 #include "../Utilities/Timer.h"
 #include "../Utilities/VirtualFile.h"
 #include "../Utilities/SimpleLock.h"
@@ -33,6 +34,7 @@ class SpcHud;
 class FrameLimiter;
 class DebugStats;
 class Msu1;
+class Serializer;
 
 enum class MemoryOperationType;
 enum class SnesMemoryType;
@@ -91,11 +93,17 @@ private:
 	atomic<bool> _isRunAheadFrame;
 	bool _frameRunning = false;
 
+	unique_ptr<Serializer> _runAheadState;
+
 	unique_ptr<DebugStats> _stats;
 	unique_ptr<FrameLimiter> _frameLimiter;
 	Timer _lastFrameTimer;
 	double _frameDelay = 0;
 
+#ifdef MESEN_BENCHMARK
+	BenchmarkCounters _benchmarkCounters;
+#endif
+
 	double GetFrameDelay();
 	void UpdateRegion();
 	void WaitForLock();
@@ -142,7 +150,12 @@ public:
 	bool IsThreadPaused();
 
 	void Serialize(ostream &out, int compressionLevel = 1);
+	void Serialize(Serializer &serializer);
 	void Deserialize(istream &in, uint32_t fileFormatVersion, bool compressed = true);
+	void Deserialize(Serializer &serializer);
+
+	void SaveSnapshot(Serializer &snapshot);
+	void LoadSnapshot(Serializer &snapshot);
 
 	shared_ptr<SoundMixer> GetSoundMixer();
 	shared_ptr<VideoRenderer> GetVideoRenderer();
@@ -169,7 +182,7 @@ public:
 
 	shared_ptr<Debugger> GetDebugger(bool autoStart = true);
 	void StopDebugger();
-	bool IsDebugging();
+	__forceinline bool IsDebugging() { return _debugger != nullptr; }
 
 	thread::id GetEmulationThreadId();
 	
@@ -181,6 +194,10 @@ public:
 
 	void CopyRewindData(shared_ptr<Console> sourceConsole);
 
+#ifdef MESEN_BENCHMARK
+	BenchmarkCounters* GetBenchmarkCounters() { return &_benchmarkCounters; }
+#endif
+
 	template<CpuType type> __forceinline void ProcessMemoryRead(uint32_t addr, uint8_t value, MemoryOperationType opType)
 	{
 		if(_debugger) {
@@ -331,6 +331,7 @@ public:
 	void Exec();
 
 	CpuState GetState();
+	CpuState& GetStateRef() { return _state; }
 	bool GetCpuProcFlag(ProcFlags::ProcFlags flag);
 	uint64_t GetCycleCount();
 
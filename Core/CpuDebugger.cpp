@@ -8,6 +8,7 @@
 #include "Sa1.h"
 #include "TraceLogger.h"
 #include "CallstackManager.h"
+#include "Profiler.h"
 #include "BreakpointManager.h"
 #include "MemoryManager.h"
 #include "CodeDataLogger.h"
@@ -36,14 +37,16 @@ CpuDebugger::CpuDebugger(Debugger* debugger, CpuType cpuType)
 	_codeDataLogger = debugger->GetCodeDataLogger(CpuType::Cpu).get();
 	_settings = debugger->GetConsole()->GetSettings().get();
 	_memoryManager = debugger->GetConsole()->GetMemoryManager().get();
+	_memoryMappings = _cpuType == CpuType::Cpu ? _memoryManager->GetMemoryMappings() : _sa1->GetMemoryMappings();
+	_cpuState = _cpuType == CpuType::Cpu ? &_cpu->GetStateRef() : &_sa1->GetCpuStateRef();
 	
 	_eventManager.reset(new EventManager(debugger, _cpu, _debugger->GetConsole()->GetPpu().get(), _memoryManager, _debugger->GetConsole()->GetDmaController().get()));
-	_callstackManager.reset(new CallstackManager(debugger));
+	_callstackManager.reset(new CallstackManager(debugger, cpuType));
 	_breakpointManager.reset(new BreakpointManager(debugger, cpuType, _eventManager.get()));
 	_step.reset(new StepRequest());
 	_assembler.reset(new Assembler(_debugger->GetLabelManager()));
 
-	if(GetState().PC == 0) {
+	if(_cpuState->PC == 0) {
 		//Enable breaking on uninit reads when debugger is opened at power on
 		_enableBreakOnUninitRead = true;
 	}
@@ -52,15 +55,17 @@ CpuDebugger::CpuDebugger(Debugger* debugger, CpuType cpuType)
 void CpuDebugger::Reset()
 {
 	_enableBreakOnUninitRead = true;
-	_callstackManager.reset(new CallstackManager(_debugger));
+	shared_ptr<CallstackManager> prevCallstackManager = _callstackManager;
+	_callstackManager.reset(new CallstackManager(_debugger, _cpuType));
+	_callstackManager->GetProfiler()->CopyMode(prevCallstackManager->GetProfiler());
 	_prevOpCode = 0xFF;
 }
 
 void CpuDebugger::ProcessRead(uint32_t addr, uint8_t value, MemoryOperationType type)
 {
-	AddressInfo addressInfo = GetMemoryMappings().GetAbsoluteAddress(addr);
+	AddressInfo addressInfo = _memoryMappings->GetAbsoluteAddress(addr);
 	MemoryOperationInfo operation = { addr, value, type };
-	CpuState state = GetState();
+	CpuState &state = *_cpuState;
 	BreakSource breakSource = BreakSource::Unspecified;
 
 	if(type == MemoryOperationType::ExecOpCode) {
@@ -90,14 +95,19 @@ void CpuDebugger::ProcessRead(uint32_t addr, uint8_t value, MemoryOperationType
 			//JSR, JSL
 			uint8_t opSize = DisassemblyInfo::GetOpSize(_prevOpCode, state.PS, _cpuType);
 			uint32_t returnPc = (_prevProgramCounter & 0xFF0000) | (((_prevProgramCounter & 0xFFFF) + opSize) & 0xFFFF);
-			AddressInfo srcAddress = GetMemoryMappings().GetAbsoluteAddress(_prevProgramCounter);
-			AddressInfo retAddress = GetMemoryMappings().GetAbsoluteAddress(returnPc);
-			_callstackManager->Push(srcAddress, _prevProgramCounter, addressInfo, pc, retAddress, returnPc, StackFrameFlags::None);
+			AddressInfo retAddress = _memoryMappings->GetAbsoluteAddress(returnPc);
+			_callstackManager->Push(_prevProgramCounter, addressInfo, pc, retAddress, returnPc, StackFrameFlags::None);
 		} else if(_prevOpCode == 0x60 || _prevOpCode == 0x6B || _prevOpCode == 0x40) {
 			//RTS, RTL, RTI
 			_callstackManager->Pop(addressInfo, pc);
 		}
 
+		Profiler* profiler = _callstackManager->GetProfiler();
+		if(profiler->IsSampling()) {
+			//The SA1 only catches up to the master clock periodically, so its own cycle counter is used instead
+			profiler->ProcessInstruction(addressInfo, _cpuType == CpuType::Cpu ? _memoryManager->GetMasterClock() : state.CycleCount);
+		}
+
 		if(_step->BreakAddress == (int32_t)pc && (_prevOpCode == 0x60 || _prevOpCode == 0x40 || _prevOpCode == 0x6B || _prevOpCode == 0x44 || _prevOpCode == 0x54)) {
 			//RTS/RTL/RTI found, if we're on the expected return address, break immediately (for step over/step out)
 			_step->StepCount = 0;
@@ -163,7 +173,7 @@ void CpuDebugger::ProcessRead(uint32_t addr, uint8_t value, MemoryOperationType
 
 void CpuDebugger::ProcessWrite(uint32_t addr, uint8_t value, MemoryOperationType type)
 {
-	AddressInfo addressInfo = GetMemoryMappings().GetAbsoluteAddress(addr);
+	AddressInfo addressInfo = _memoryMappings->GetAbsoluteAddress(addr);
 	MemoryOperationInfo operation = { addr, value, type };
 	if(addressInfo.Address >= 0 && (addressInfo.Type == SnesMemoryType::WorkRam || addressInfo.Type == SnesMemoryType::SaveRam)) {
 		_disassembler->InvalidateCache(addressInfo, _cpuType);
@@ -186,7 +196,7 @@ void CpuDebugger::Run()
 void CpuDebugger::Step(int32_t stepCount, StepType type)
 {
 	StepRequest step;
-	if((type == StepType::StepOver || type == StepType::StepOut || type == StepType::Step) && GetState().StopState == CpuStopState::Stopped) {
+	if((type == StepType::StepOver || type == StepType::StepOut || type == StepType::Step) && _cpuState->StopState == CpuStopState::Stopped) {
 		//If STP was called, the CPU isn't running anymore - use the PPU to break execution instead (useful for test roms that end with STP)
 		step.PpuStepCount = 1;
 	} else {
@@ -212,10 +222,9 @@ void CpuDebugger::Step(int32_t stepCount, StepType type)
 
 void CpuDebugger::ProcessInterrupt(uint32_t originalPc, uint32_t currentPc, bool forNmi)
 {
-	AddressInfo src = GetMemoryMappings().GetAbsoluteAddress(_prevProgramCounter);
-	AddressInfo ret = GetMemoryMappings().GetAbsoluteAddress(originalPc);
-	AddressInfo dest = GetMemoryMappings().GetAbsoluteAddress(currentPc);
-	_callstackManager->Push(src, _prevProgramCounter, dest, currentPc, ret, originalPc, forNmi ? StackFrameFlags::Nmi : StackFrameFlags::Irq);
+	AddressInfo ret = _memoryMappings->GetAbsoluteAddress(originalPc);
+	AddressInfo dest = _memoryMappings->GetAbsoluteAddress(currentPc);
+	_callstackManager->Push(_prevProgramCounter, dest, currentPc, ret, originalPc, forNmi ? StackFrameFlags::Nmi : StackFrameFlags::Irq);
 	_eventManager->AddEvent(forNmi ? DebugEventType::Nmi : DebugEventType::Irq);
 }
 
@@ -234,24 +243,6 @@ void CpuDebugger::ProcessPpuCycle(uint16_t scanline, uint16_t cycle)
 	}
 }
 
-MemoryMappings& CpuDebugger::GetMemoryMappings()
-{
-	if(_cpuType == CpuType::Cpu) {
-		return *_memoryManager->GetMemoryMappings();
-	} else {
-		return *_sa1->GetMemoryMappings();
-	}
-}
-
-CpuState CpuDebugger::GetState()
-{
-	if(_cpuType == CpuType::Cpu) {
-		return _cpu->GetState();
-	} else {
-		return _sa1->GetCpuState();
-	}
-}
-
 bool CpuDebugger::IsRegister(uint32_t addr)
 {
 	return _cpuType == CpuType::Cpu && _memoryManager->IsRegister(addr);
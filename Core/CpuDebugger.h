@@ -31,6 +31,10 @@ class CpuDebugger final : public IDebugger
 	Cpu* _cpu;
 	Sa1* _sa1;
 
+	//Resolved once, the CPU's state is read in place on each instruction
+	MemoryMappings* _memoryMappings;
+	CpuState* _cpuState;
+
 	shared_ptr<EventManager> _eventManager;
 	shared_ptr<Assembler> _assembler;
 	shared_ptr<CallstackManager> _callstackManager;
@@ -43,8 +47,6 @@ class CpuDebugger final : public IDebugger
 	uint32_t _prevProgramCounter = 0;
 	DebugState _debugState;
 
-	MemoryMappings& GetMemoryMappings();
-	CpuState GetState();
 	bool IsRegister(uint32_t addr);
 
 public:
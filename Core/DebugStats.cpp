@@ -17,8 +17,8 @@ void DebugStats::DisplayStats(Console *console, double lastFrameTime)
 
 	int startFrame = console->GetFrameCount();
 
-	hud->DrawRectangle(8, 8, 115, 49, 0x40000000, true, 1, startFrame);
-	hud->DrawRectangle(8, 8, 115, 49, 0xFFFFFF, false, 1, startFrame);
+	hud->DrawRectangle(8, 8, 115, 58, 0x40000000, true, 1, startFrame);
+	hud->DrawRectangle(8, 8, 115, 58, 0xFFFFFF, false, 1, startFrame);
 
 	hud->DrawString(10, 10, "Audio Stats", 0xFFFFFF, 0xFF000000, 1, startFrame);
 	hud->DrawString(10, 21, "Latency: ", 0xFFFFFF, 0xFF000000, 1, startFrame);
@@ -32,6 +32,13 @@ void DebugStats::DisplayStats(Console *console, double lastFrameTime)
 	hud->DrawString(10, 39, "Buffer Size: " + std::to_string(stats.BufferSize / 1024) + "kb", 0xFFFFFF, 0xFF000000, 1, startFrame);
 	hud->DrawString(10, 48, "Rate: " + std::to_string((uint32_t)(audioCfg.SampleRate *  console->GetSoundMixer()->GetRateAdjustment())) + "Hz", 0xFFFFFF, 0xFF000000, 1, startFrame);
 
+	ss = std::stringstream();
+	ss << "Mixer: " << std::fixed << std::setprecision(2) << stats.MixerLatency << " ms";
+	if(stats.MixerOverrunCount > 0) {
+		ss << " (" << stats.MixerOverrunCount << ")";
+	}
+	hud->DrawString(10, 57, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+
 	hud->DrawRectangle(132, 8, 115, 49, 0x40000000, true, 1, startFrame);
 	hud->DrawRectangle(132, 8, 115, 49, 0xFFFFFF, false, 1, startFrame);
 	hud->DrawString(134, 10, "Video Stats", 0xFFFFFF, 0xFF000000, 1, startFrame);
@@ -31,6 +31,19 @@ struct DebugState
 	AluState Alu;
 };
 
+//Incremented each time the matching part of the published DebugState changes
+struct DebugStateGenerations
+{
+	uint32_t State;
+	uint32_t Cpu;
+	uint32_t Ppu;
+	uint32_t Spc;
+	uint32_t Dsp;
+	uint32_t Dma;
+	uint32_t Coprocessor;
+	uint32_t Gameboy;
+};
+
 struct AddressInfo
 {
 	int32_t Address;
@@ -98,6 +98,8 @@ Debugger::Debugger(shared_ptr<Console> console)
 	_executionStopped = true;
 	_breakRequestCount = 0;
 	_suspendRequestCount = 0;
+	_snapshotStale = true;
+	_snapshotRequested = false;
 
 	CpuType cpuType = _gbDebugger ? CpuType::Gameboy : CpuType::Cpu;
 	string cdlFile = FolderUtilities::CombinePath(FolderUtilities::GetDebuggerFolder(), FolderUtilities::GetFilename(_cart->GetRomInfo().RomFile.GetFileName(), false) + ".cdl");
@@ -129,6 +131,7 @@ void Debugger::Release()
 
 void Debugger::Reset()
 {
+	InvalidateStateSnapshot();
 	_memoryAccessCounter->ResetCounts();
 	_cpuDebugger->Reset();
 	_spcDebugger->Reset();
@@ -271,6 +274,7 @@ void Debugger::SleepUntilResume(BreakSource source, MemoryOperationInfo *operati
 		_disassembler->RefreshDisassembly(CpuType::Gameboy);
 	}
 
+	PublishState();
 	_executionStopped = true;
 	
 	if(source != BreakSource::Unspecified || _breakRequestCount == 0) {
@@ -324,16 +328,24 @@ void Debugger::ProcessEvent(EventType type)
 		default: break;
 
 		case EventType::StartFrame:
+			if(_snapshotRequested.exchange(false)) {
+				PublishState();
+			}
 			_console->GetNotificationManager()->SendNotification(ConsoleNotificationType::EventViewerRefresh, (void*)CpuType::Cpu);
 			GetEventManager(CpuType::Cpu)->ClearFrameEvents();
+			FlushCdlFile();
 			break;
 
 		case EventType::GbStartFrame:
 			if(_settings->CheckFlag(EmulationFlags::GameboyMode)) {
 				_scriptManager->ProcessEvent(EventType::StartFrame);
 			}
+			if(_snapshotRequested.exchange(false)) {
+				PublishState();
+			}
 			_console->GetNotificationManager()->SendNotification(ConsoleNotificationType::EventViewerRefresh, (void*)CpuType::Gameboy);
 			GetEventManager(CpuType::Gameboy)->ClearFrameEvents();
+			FlushCdlFile();
 			break;
 		
 		case EventType::GbEndFrame:
@@ -347,6 +359,7 @@ void Debugger::ProcessEvent(EventType type)
 			break;
 
 		case EventType::StateLoaded:
+			InvalidateStateSnapshot();
 			_memoryAccessCounter->ResetCounts();
 			break;
 	}
@@ -356,7 +369,11 @@ int32_t Debugger::EvaluateExpression(string expression, CpuType cpuType, EvalRes
 {
 	MemoryOperationInfo operationInfo { 0, 0, MemoryOperationType::Read };
 	DebugState state;
-	GetState(state, false);
+	if(_console->GetEmulationThreadId() == std::this_thread::get_id()) {
+		GetState(state, false);
+	} else {
+		GetStateSnapshot(state);
+	}
 	if(useCache) {
 		return _watchExpEval[(int)cpuType]->Evaluate(expression, state, resultType, operationInfo);
 	} else {
@@ -511,6 +528,83 @@ void Debugger::GetState(DebugState &state, bool partialPpuState)
 	}
 }
 
+void Debugger::FlushCdlFile()
+{
+	if(_cdlFlushTimer.GetElapsedMS() >= Debugger::CdlFlushInterval) {
+		_cdlFlushTimer.Reset();
+		GetCodeDataLogger(_gbDebugger ? CpuType::Gameboy : CpuType::Cpu)->Flush();
+	}
+}
+
+void Debugger::PublishState()
+{
+	auto publishLock = _publishLock.AcquireSafe();
+
+	//Readers only access the front buffer, so the back buffer can be filled without blocking them
+	DebugState &prevState = _stateSnapshots[_snapshotIndex];
+	DebugState &state = _stateSnapshots[_snapshotIndex ^ 1];
+
+	//Changes are detected with memcmp, so padding bytes must not keep stale values from the previous snapshot
+	memset((void*)&state, 0, sizeof(state));
+	GetState(state, false);
+
+	DebugStateGenerations generations = _stateGenerations;
+	auto updateGeneration = [](uint32_t &generation, void* prev, void* current, size_t size) {
+		if(memcmp(prev, current, size) != 0) {
+			generation++;
+		}
+	};
+	updateGeneration(generations.Cpu, &prevState.Cpu, &state.Cpu, sizeof(state.Cpu));
+	updateGeneration(generations.Ppu, &prevState.Ppu, &state.Ppu, sizeof(state.Ppu));
+	updateGeneration(generations.Spc, &prevState.Spc, &state.Spc, sizeof(state.Spc));
+	updateGeneration(generations.Dsp, &prevState.Dsp, &state.Dsp, sizeof(state.Dsp));
+	updateGeneration(generations.Dma, &prevState.DmaChannels, &state.DmaChannels, sizeof(state.DmaChannels) + sizeof(state.InternalRegs) + sizeof(state.Alu));
+	updateGeneration(generations.Coprocessor, &prevState.NecDsp, &state.NecDsp, sizeof(state.NecDsp));
+	updateGeneration(generations.Coprocessor, &prevState.Sa1, &state.Sa1, sizeof(state.Sa1));
+	updateGeneration(generations.Coprocessor, &prevState.Gsu, &state.Gsu, sizeof(state.Gsu));
+	updateGeneration(generations.Coprocessor, &prevState.Cx4, &state.Cx4, sizeof(state.Cx4));
+	updateGeneration(generations.Gameboy, &prevState.Gameboy, &state.Gameboy, sizeof(state.Gameboy));
+	generations.State++;
+
+	auto lock = _snapshotLock.AcquireSafe();
+	_stateGenerations = generations;
+	_snapshotIndex ^= 1;
+	_snapshotTimer.Reset();
+	_snapshotStale = false;
+}
+
+void Debugger::GetStateSnapshot(DebugState &state, DebugStateGenerations* generations)
+{
+	bool isEmulationThread = _console->GetEmulationThreadId() == std::this_thread::get_id();
+	if(!isEmulationThread) {
+		auto lock = _snapshotLock.AcquireSafe();
+		if(!_snapshotStale && (_executionStopped || _snapshotTimer.GetElapsedMS() < SnapshotMaxAge)) {
+			state = _stateSnapshots[_snapshotIndex];
+			if(generations) {
+				*generations = _stateGenerations;
+			}
+			if(!_executionStopped) {
+				//Publish a new snapshot at the start of the next frame
+				_snapshotRequested = true;
+			}
+			return;
+		}
+	}
+
+	PublishState();
+
+	auto lock = _snapshotLock.AcquireSafe();
+	state = _stateSnapshots[_snapshotIndex];
+	if(generations) {
+		*generations = _stateGenerations;
+	}
+}
+
+void Debugger::InvalidateStateSnapshot()
+{
+	_snapshotStale = true;
+}
+
 bool Debugger::GetCpuProcFlag(ProcFlags::ProcFlags flag)
 {
 	return _cpu->GetCpuProcFlag(flag);
@@ -519,41 +613,49 @@ bool Debugger::GetCpuProcFlag(ProcFlags::ProcFlags flag)
 void Debugger::SetCpuRegister(CpuRegister reg, uint16_t value)
 {
 	_cpu->SetReg(reg, value);
+	InvalidateStateSnapshot();
 }
 
 void Debugger::SetCpuProcFlag(ProcFlags::ProcFlags flag, bool set)
 {
 	_cpu->SetCpuProcFlag(flag, set);
+	InvalidateStateSnapshot();
 }
 
 void Debugger::SetCx4Register(Cx4Register reg, uint32_t value)
 {
 	_cart->GetCx4()->SetReg(reg, value);
+	InvalidateStateSnapshot();
 }
 
 void Debugger::SetGameboyRegister(GbRegister reg, uint16_t value)
 {
 	_cart->GetGameboy()->SetReg(reg, value);
+	InvalidateStateSnapshot();
 }
 
 void Debugger::SetGsuRegister(GsuRegister reg, uint16_t value)
 {
 	_cart->GetGsu()->SetReg(reg, value);
+	InvalidateStateSnapshot();
 }
 
 void Debugger::SetNecDspRegister(NecDspRegister reg, uint16_t value)
 {
 	_cart->GetDsp()->SetReg(reg, value);
+	InvalidateStateSnapshot();
 }
 
 void Debugger::SetSa1Register(CpuRegister reg, uint16_t value)
 {
 	_cart->GetSa1()->SetReg(reg, value);
+	InvalidateStateSnapshot();
 }
 
 void Debugger::SetSpcRegister(SpcRegister reg, uint16_t value)
 {
 	_spc->SetReg(reg, value);
+	InvalidateStateSnapshot();
 }
 
 AddressInfo Debugger::GetAbsoluteAddress(AddressInfo relAddress)
@@ -874,6 +976,11 @@ shared_ptr<CallstackManager> Debugger::GetCallstackManager(CpuType cpuType)
 		case CpuType::Gameboy: return _gbDebugger->GetCallstackManager();
 
 		case CpuType::Gsu:
+			if(_gsuDebugger) {
+				return _gsuDebugger->GetCallstackManager();
+			}
+			break;
+
 		case CpuType::NecDsp:
 		case CpuType::Cx4:
 			break;
@@ -5,6 +5,7 @@
 #include "DebugTypes.h"
 #include "DebugUtilities.h"
 #include "../Utilities/SimpleLock.h"
+#include "../Utilities/Timer.h"
 
 class Console;
 class Cpu;
@@ -84,8 +85,26 @@ private:
 	atomic<uint32_t> _suspendRequestCount;
 
 	bool _waitForBreakResume = false;
+
+	//Double-buffered copy of the state, published on breaks and when the UI reads the state
+	//While running, the UI reuses a snapshot published less than SnapshotMaxAge ms ago (refreshed at the start of each frame)
+	static constexpr double SnapshotMaxAge = 50;
+	DebugState _stateSnapshots[2];
+	DebugStateGenerations _stateGenerations = {};
+	uint32_t _snapshotIndex = 0;
+	SimpleLock _snapshotLock;
+	SimpleLock _publishLock;
+	Timer _snapshotTimer;
+	atomic<bool> _snapshotStale;
+	atomic<bool> _snapshotRequested;
+
+	//The CDL file is memory-mapped, its modified pages are written back to the disk every CdlFlushInterval ms
+	static constexpr double CdlFlushInterval = 10000;
+	Timer _cdlFlushTimer;
 	
 	void Reset();
+	void PublishState();
+	void FlushCdlFile();
 
 public:
 	Debugger(shared_ptr<Console> console);
@@ -128,6 +147,8 @@ public:
 	void SleepUntilResume(BreakSource source, MemoryOperationInfo* operation = nullptr, int breakpointId = -1);
 
 	void GetState(DebugState& state, bool partialPpuState);
+	void GetStateSnapshot(DebugState& state, DebugStateGenerations* generations = nullptr);
+	void InvalidateStateSnapshot();
 	bool GetCpuProcFlag(ProcFlags::ProcFlags flag);
 
 	void SetCpuRegister(CpuRegister reg, uint16_t value);
@@ -5,6 +5,7 @@
 #include "Console.h"
 #include "EmuSettings.h"
 #include "SettingTypes.h"
+#include "VideoFilterKernels.h"
 
 const static double PI = 3.14159265358979323846;
 
@@ -79,6 +80,8 @@ void DefaultVideoFilter::InitLookupTable()
 		}
 	}
 
+	//Without any color adjustments, the palette matches ToArgb() and can be calculated on the fly
+	_useDefaultPalette = !_gbcAdjustColors && config.Hue == 0 && config.Saturation == 0 && config.Brightness == 0 && config.Contrast == 0;
 	_videoConfig = config;
 }
 
@@ -123,7 +126,11 @@ void DefaultVideoFilter::ApplyFilter(uint16_t *ppuOutputBuffer)
 	uint32_t yOffset = overscan.Top * overscanMultiplier * width;
 
 	uint8_t scanlineIntensity = (uint8_t)((1.0 - _console->GetSettings()->GetVideoConfig().ScanlineIntensity) * 255);
-	if(scanlineIntensity < 255) {
+	if(_useDefaultPalette && !_gbBlendFrames) {
+		for(uint32_t i = 0; i < frameInfo.Height; i++) {
+			VideoFilterKernels::ConvertRgb555ToArgb(ppuOutputBuffer + i * width + yOffset + xOffset, out + i * frameInfo.Width, frameInfo.Width, (i & 0x01) ? scanlineIntensity : 255);
+		}
+	} else if(scanlineIntensity < 255) {
 		for(uint32_t i = 0; i < frameInfo.Height; i++) {
 			if(i & 0x01) {
 				for(uint32_t j = 0; j < frameInfo.Width; j++) {
@@ -14,6 +14,7 @@ private:
 	uint16_t* _prevFrame = nullptr;
 	bool _gbBlendFrames = false;
 	bool _gbcAdjustColors = false;
+	bool _useDefaultPalette = true;
 
 	void InitConversionMatrix(double hueShift, double saturationShift);
 	void InitLookupTable();
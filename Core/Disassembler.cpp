@@ -31,6 +31,7 @@ Disassembler::Disassembler(shared_ptr<Console> console, shared_ptr<CodeDataLogge
 {
 	shared_ptr<BaseCartridge> cart = console->GetCartridge();
 
+	_stamp = 1;
 	_cdl = cdl;
 	_debugger = debugger;
 	_labelManager = debugger->GetLabelManager();
@@ -68,6 +69,9 @@ void Disassembler::InitSource(SnesMemoryType type)
 	uint32_t size = _memoryDumper->GetMemorySize(type);
 	_disassemblyCache[(int)type] = vector<DisassemblyInfo>(size);
 	_sources[(int)type] = { src, &_disassemblyCache[(int)type], size };
+
+	//Any existing disassembly for this memory type is out of date
+	_pageStamps[(int)type] = vector<uint32_t>((size >> PageShift) + 1, _stamp);
 }
 
 DisassemblerSource& Disassembler::GetSource(SnesMemoryType type)
@@ -95,6 +99,7 @@ uint32_t Disassembler::BuildCache(AddressInfo &addrInfo, uint8_t cpuFlags, CpuTy
 				//(can happen when resizing an instruction after X/M updates)
 				(*src.Cache)[address + i] = DisassemblyInfo();
 			}
+			MarkDirty(addrInfo.Type, address, address + disInfo.GetOpSize() - 1);
 			needDisassemble = true;
 			returnSize += disInfo.GetOpSize();
 		} else {
@@ -151,6 +156,7 @@ void Disassembler::InvalidateCache(AddressInfo addrInfo, CpuType type)
 			if(addrInfo.Address >= i) {
 				if((*src.Cache)[addrInfo.Address - i].IsInitialized()) {
 					(*src.Cache)[addrInfo.Address - i].Reset();
+					MarkDirty(addrInfo.Type, addrInfo.Address - i, addrInfo.Address - i);
 					needDisassemble = true;
 				}
 			}
@@ -162,6 +168,44 @@ void Disassembler::InvalidateCache(AddressInfo addrInfo, CpuType type)
 	}
 }
 
+void Disassembler::MarkDirty(SnesMemoryType type, int32_t start, int32_t end)
+{
+	vector<uint32_t> &stamps = _pageStamps[(int)type];
+	for(int32_t page = start >> PageShift, last = std::min(end >> PageShift, (int32_t)stamps.size() - 1); page <= last; page++) {
+		stamps[page] = _stamp;
+	}
+}
+
+bool Disassembler::IsDirty(SnesMemoryType type, int32_t start, int32_t end, uint32_t stamp)
+{
+	vector<uint32_t> &stamps = _pageStamps[(int)type];
+	if(stamps.empty()) {
+		return true;
+	}
+
+	for(int32_t page = start >> PageShift, last = std::min(end >> PageShift, (int32_t)stamps.size() - 1); page <= last; page++) {
+		if(stamps[page] > stamp) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void Disassembler::MarkDirty(AddressInfo addrInfo)
+{
+	if(addrInfo.Address >= 0 && (int)addrInfo.Type < (int)SnesMemoryType::Register) {
+		MarkDirty(addrInfo.Type, addrInfo.Address, addrInfo.Address);
+	}
+}
+
+void Disassembler::MarkAllDirty()
+{
+	auto lock = _disassemblyLock.AcquireSafe();
+	for(int i = 0; i <= (int)DebugUtilities::GetLastCpuType(); i++) {
+		_segments[i].clear();
+	}
+}
+
 void Disassembler::Disassemble(CpuType cpuType)
 {
 	if(!_needDisassemble[(int)cpuType]) {
@@ -224,33 +268,189 @@ void Disassembler::Disassemble(CpuType cpuType)
 		default: throw std::runtime_error("Disassemble(): Invalid cpu type");
 	}
 
-	vector<DisassemblyResult> &results = _disassemblyResult[(int)cpuType];
-	results.clear();
+	_cdl->ProcessChangedPages([this](uint32_t start, uint32_t end) {
+		MarkDirty(SnesMemoryType::PrgRom, start, end);
+	});
 
 	bool disUnident = _settings->CheckDebuggerFlag(DebuggerFlags::DisassembleUnidentifiedData);
 	bool disData = _settings->CheckDebuggerFlag(DebuggerFlags::DisassembleVerifiedData);
 	bool showUnident = _settings->CheckDebuggerFlag(DebuggerFlags::ShowUnidentifiedData);
 	bool showData = _settings->CheckDebuggerFlag(DebuggerFlags::ShowVerifiedData);
+	uint8_t scanFlags = (disUnident ? 0x01 : 0) | (disData ? 0x02 : 0) | (showUnident ? 0x04 : 0) | (showData ? 0x08 : 0);
+
+	vector<DisassemblySegment> &segments = _segments[(int)cpuType];
+	vector<DisassemblyResult> &prevResults = _disassemblyResult[(int)cpuType];
+	if(scanFlags != _scanFlags[(int)cpuType]) {
+		segments.clear();
+		_scanFlags[(int)cpuType] = scanFlags;
+	}
 
-	bool inUnknownBlock = false;
-	bool inVerifiedBlock = false;
+	uint32_t segmentCount = ((uint32_t)maxAddr >> SegmentShift) + 1;
+	if(segments.size() != segmentCount) {
+		segments.clear();
+		segments.resize(segmentCount);
+		for(DisassemblySegment &segment : segments) {
+			//Never matches a real address, forces the segment to be disassembled
+			segment.Start = { -2, SnesMemoryType::Register };
+		}
+	}
+
+	vector<DisassemblyResult> results;
+	results.reserve(prevResults.size() + 16);
+
+	vector<DisassemblyRange> &prevRanges = _segmentRanges[(int)cpuType];
+	vector<DisassemblyRange> ranges;
+	ranges.reserve(prevRanges.size() + 16);
+
+	//Anything marked dirty after this point gets a higher stamp, and is picked up by the next scan
+	uint32_t scanStamp = _scanStamp[(int)cpuType];
+	uint32_t newScanStamp = _stamp++;
+
+	DisassemblerScanState state = {};
+	DisassemblerScanState prevEndState = {};
+	for(uint32_t i = 0; i < segmentCount; i++) {
+		DisassemblySegment &segment = segments[i];
+		int32_t start = (int32_t)(i << SegmentShift);
+		int32_t end = std::min(start + (1 << SegmentShift) - 1, maxAddr);
+		AddressInfo startAddr = GetAbsoluteAddress(cpuType, mappings, start);
+		AddressInfo endAddr = GetAbsoluteAddress(cpuType, mappings, end);
+
+		bool reuse = (
+			segment.Start.Address == startAddr.Address && segment.Start.Type == startAddr.Type &&
+			segment.End.Address == endAddr.Address && segment.End.Type == endAddr.Type &&
+			IsSameState(state, prevEndState) &&
+			IsSegmentUnchanged(cpuType, mappings, start, end, prevRanges.data() + segment.FirstRange, segment.RangeCount, disUnident, scanStamp)
+		);
+
+		prevEndState = segment.EndState;
+		uint32_t firstLine = (uint32_t)results.size();
+		uint32_t firstRange = (uint32_t)ranges.size();
+		if(reuse) {
+			results.insert(results.end(), prevResults.begin() + segment.FirstLine, prevResults.begin() + segment.FirstLine + segment.LineCount);
+			ranges.insert(ranges.end(), prevRanges.begin() + segment.FirstRange, prevRanges.begin() + segment.FirstRange + segment.RangeCount);
+			state = segment.EndState;
+		} else {
+			DisassembleSegment(cpuType, mappings, start, end, scanFlags, state, results, ranges);
+			segment.Start = startAddr;
+			segment.End = endAddr;
+			segment.EndState = state;
+		}
+		segment.FirstLine = firstLine;
+		segment.LineCount = (uint32_t)results.size() - firstLine;
+		segment.FirstRange = firstRange;
+		segment.RangeCount = (uint32_t)ranges.size() - firstRange;
+	}
+
+	if(state.InUnknownBlock || state.InVerifiedBlock) {
+		int flags = LineFlags::BlockEnd | (state.InVerifiedBlock ? LineFlags::VerifiedData : 0) | (((state.InVerifiedBlock && showData) || (state.InUnknownBlock && showUnident)) ? LineFlags::ShowAsData : 0);
+		results.push_back(DisassemblyResult(state.AddrInfo, maxAddr, flags));
+	}
+
+	prevResults.swap(results);
+	prevRanges.swap(ranges);
+	BuildLineIndex(cpuType);
+
+	_scanStamp[(int)cpuType] = newScanStamp;
+}
+
+AddressInfo Disassembler::GetAbsoluteAddress(CpuType type, MemoryMappings* mappings, int32_t address)
+{
+	switch(type) {
+		case CpuType::Spc: return _spc->GetAbsoluteAddress(address);
+		case CpuType::NecDsp: return { address, SnesMemoryType::DspProgramRom };
+		case CpuType::Gameboy: return _gameboy->GetAbsoluteAddress(address);
+		default: return mappings->GetAbsoluteAddress(address);
+	}
+}
+
+bool Disassembler::IsSameState(DisassemblerScanState &a, DisassemblerScanState &b)
+{
+	return (
+		a.AddrInfo.Address == b.AddrInfo.Address && a.AddrInfo.Type == b.AddrInfo.Type &&
+		a.NextAddress == b.NextAddress && a.ByteCounter == b.ByteCounter &&
+		a.InUnknownBlock == b.InUnknownBlock && a.InVerifiedBlock == b.InVerifiedBlock
+	);
+}
+
+bool Disassembler::IsSegmentUnchanged(CpuType type, MemoryMappings* mappings, int32_t start, int32_t end, DisassemblyRange* ranges, uint32_t rangeCount, bool disUnident, uint32_t stamp)
+{
+	//Each block of memory the segment was built from must still be mapped at the same CPU addresses, and must not have been modified since
+	for(uint32_t i = 0; i < rangeCount; i++) {
+		DisassemblyRange &range = ranges[i];
+		int32_t lastAddress = range.Start.Address + range.Length - 1;
+		int32_t lastCpuAddress = range.CpuAddress + range.Length - 1;
+
+		//The segment's first and last addresses have already been compared by the caller
+		if(range.CpuAddress != start) {
+			AddressInfo first = GetAbsoluteAddress(type, mappings, range.CpuAddress);
+			if(first.Address != range.Start.Address || first.Type != range.Start.Type) {
+				return false;
+			}
+		}
+		if(lastCpuAddress != end) {
+			AddressInfo last = GetAbsoluteAddress(type, mappings, lastCpuAddress);
+			if(last.Address != lastAddress || last.Type != range.Start.Type) {
+				return false;
+			}
+		}
+
+		if(disUnident && !IsReadOnlyMemory(range.Start.Type)) {
+			//Unidentified bytes in RAM can be disassembled as code, and are not tracked
+			return false;
+		}
+
+		//Instructions that end past the range can change its last lines
+		if(IsDirty(range.Start.Type, range.Start.Address, lastAddress + 3, stamp)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Disassembler::IsReadOnlyMemory(SnesMemoryType type)
+{
+	switch(type) {
+		case SnesMemoryType::PrgRom:
+		case SnesMemoryType::SpcRom:
+		case SnesMemoryType::DspProgramRom:
+		case SnesMemoryType::GbPrgRom:
+		case SnesMemoryType::GbBootRom:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+void Disassembler::DisassembleSegment(CpuType type, MemoryMappings* mappings, int32_t start, int32_t end, uint8_t scanFlags, DisassemblerScanState &state, vector<DisassemblyResult> &results, vector<DisassemblyRange> &ranges)
+{
+	bool disUnident = (scanFlags & 0x01) != 0;
+	bool disData = (scanFlags & 0x02) != 0;
+	bool showUnident = (scanFlags & 0x04) != 0;
+	bool showData = (scanFlags & 0x08) != 0;
+
+	bool inUnknownBlock = state.InUnknownBlock;
+	bool inVerifiedBlock = state.InVerifiedBlock;
+	int byteCounter = state.ByteCounter;
 	LabelInfo labelInfo;
-	AddressInfo addrInfo = {};
+	AddressInfo addrInfo = state.AddrInfo;
 	AddressInfo prevAddrInfo = {};
-	int byteCounter = 0;
-	for(int32_t i = 0; i <= maxAddr; i++) {
+	size_t firstRange = ranges.size();
+	int32_t i;
+	for(i = std::max(start, state.NextAddress); i <= end; i++) {
 		prevAddrInfo = addrInfo;
-		switch(cpuType) {
-			case CpuType::Spc: addrInfo = _spc->GetAbsoluteAddress(i); break;
-			case CpuType::NecDsp: addrInfo = { i, SnesMemoryType::DspProgramRom }; break;
-			case CpuType::Gameboy: addrInfo = _gameboy->GetAbsoluteAddress(i); break;
-			default: addrInfo = mappings->GetAbsoluteAddress(i); break;
-		}
+		addrInfo = GetAbsoluteAddress(type, mappings, i);
 
 		if(addrInfo.Address < 0) {
 			continue;
 		}
 
+		if(ranges.size() == firstRange || ranges.back().Start.Type != addrInfo.Type || ranges.back().Start.Address + (i - ranges.back().CpuAddress) != addrInfo.Address) {
+			ranges.push_back({ addrInfo, i, 1 });
+		} else {
+			ranges.back().Length = i - ranges.back().CpuAddress + 1;
+		}
+
 		DisassemblerSource src = GetSource(addrInfo.Type);
 
 		DisassemblyInfo disassemblyInfo = (*src.Cache)[addrInfo.Address];
@@ -264,7 +464,7 @@ void Disassembler::Disassemble(CpuType cpuType)
 		if(disassemblyInfo.IsInitialized()) {
 			opSize = disassemblyInfo.GetOpSize();
 		} else if((isData && disData) || (!isData && !isCode && disUnident)) {
-			opSize = DisassemblyInfo::GetOpSize(opCode, 0, cpuType);
+			opSize = DisassemblyInfo::GetOpSize(opCode, 0, type);
 		}
 
 		if(opSize > 0) {
@@ -316,7 +516,7 @@ void Disassembler::Disassemble(CpuType cpuType)
 				i++;
 			}
 
-			if(DisassemblyInfo::IsReturnInstruction(opCode, cpuType)) {
+			if(DisassemblyInfo::IsReturnInstruction(opCode, type)) {
 				//End of function
 				results.push_back(DisassemblyResult(-1, LineFlags::VerifiedCode | LineFlags::BlockEnd));
 			} 
@@ -366,9 +566,24 @@ void Disassembler::Disassemble(CpuType cpuType)
 		}
 	}
 
-	if(inUnknownBlock || inVerifiedBlock) {
-		int flags = LineFlags::BlockEnd | (inVerifiedBlock ? LineFlags::VerifiedData : 0) | (((inVerifiedBlock && showData) || (inUnknownBlock && showUnident)) ? LineFlags::ShowAsData : 0);
-		results.push_back(DisassemblyResult(addrInfo, maxAddr, flags));
+	state.AddrInfo = addrInfo;
+	state.NextAddress = i;
+	state.ByteCounter = byteCounter;
+	state.InUnknownBlock = inUnknownBlock;
+	state.InVerifiedBlock = inVerifiedBlock;
+}
+
+void Disassembler::BuildLineIndex(CpuType type)
+{
+	//Lines that GetLineIndex can match, their addresses are in increasing order
+	vector<DisassemblyResult> &source = _disassemblyResult[(int)type];
+	vector<uint32_t> &lines = _addressLines[(int)type];
+	lines.clear();
+	for(size_t i = 1; i < source.size(); i++) {
+		if(source[i].CpuAddress < 0 || (source[i].Flags & LineFlags::SubStart) | (source[i].Flags & LineFlags::Label) || ((source[i].Flags & LineFlags::Comment) && source[i].CommentLine >= 0)) {
+			continue;
+		}
+		lines.push_back((uint32_t)i);
 	}
 }
 
@@ -399,21 +614,17 @@ uint32_t Disassembler::GetLineIndex(CpuType type, uint32_t cpuAddress)
 {
 	auto lock = _disassemblyLock.AcquireSafe();
 	vector<DisassemblyResult>& source = _disassemblyResult[(int)type];
-	uint32_t lastAddress = 0;
-	for(size_t i = 1; i < source.size(); i++) {
-		if(source[i].CpuAddress < 0 || (source[i].Flags & LineFlags::SubStart) | (source[i].Flags & LineFlags::Label) || ((source[i].Flags & LineFlags::Comment) && source[i].CommentLine >= 0)) {
-			continue;
-		}
+	vector<uint32_t>& lines = _addressLines[(int)type];
 
-		if(cpuAddress == (uint32_t)source[i].CpuAddress) {
-			return (uint32_t)i;
-		} else if(cpuAddress >= lastAddress && cpuAddress < (uint32_t)source[i].CpuAddress) {
-			return (uint32_t)i - 1;
-		}
+	//Find the first line at or after the address - if its address doesn't match, return the line before it
+	auto result = std::lower_bound(lines.begin(), lines.end(), cpuAddress, [&source](uint32_t lineIndex, uint32_t address) {
+		return (uint32_t)source[lineIndex].CpuAddress < address;
+	});
 
-		lastAddress = source[i].CpuAddress;
+	if(result == lines.end()) {
+		return 0;
 	}
-	return 0;
+	return (uint32_t)source[*result].CpuAddress == cpuAddress ? *result : *result - 1;
 }
 
 bool Disassembler::GetLineData(CpuType type, uint32_t lineIndex, CodeLineData &data)
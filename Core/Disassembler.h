@@ -19,6 +19,7 @@ class LabelManager;
 class CodeDataLogger;
 class MemoryDumper;
 class EmuSettings;
+class MemoryMappings;
 struct CpuState;
 enum class CpuType : uint8_t;
 
@@ -29,6 +30,35 @@ struct DisassemblerSource
 	uint32_t Size;
 };
 
+//State carried from one segment to the next while disassembling
+struct DisassemblerScanState
+{
+	AddressInfo AddrInfo;
+	int32_t NextAddress;
+	int32_t ByteCounter;
+	bool InUnknownBlock;
+	bool InVerifiedBlock;
+};
+
+//Block of CPU addresses that mapped to contiguous bytes of a single memory type when the segment was disassembled
+struct DisassemblyRange
+{
+	AddressInfo Start;
+	int32_t CpuAddress;
+	int32_t Length;
+};
+
+struct DisassemblySegment
+{
+	AddressInfo Start;
+	AddressInfo End;
+	uint32_t FirstLine;
+	uint32_t LineCount;
+	DisassemblerScanState EndState;
+	uint32_t FirstRange;
+	uint32_t RangeCount;
+};
+
 class Disassembler
 {
 private:
@@ -50,13 +80,36 @@ private:
 	DisassemblerSource _sources[(int)SnesMemoryType::Register] = {};
 	vector<DisassemblyInfo> _disassemblyCache[(int)SnesMemoryType::Register];
 
+	//The CPU address space is disassembled in segments, only segments whose content may have changed are disassembled again
+	static constexpr int SegmentShift = 8;
+	static constexpr int PageShift = 8;
+
+	//Last time each page of each memory type was modified (cache, labels, CDL)
+	//Pages are marked by the emulation thread while scans run on the UI thread, each scan reserves its own stamp
+	vector<uint32_t> _pageStamps[(int)SnesMemoryType::Register];
+	atomic<uint32_t> _stamp;
+
 	SimpleLock _disassemblyLock;
 	vector<DisassemblyResult> _disassemblyResult[(int)DebugUtilities::GetLastCpuType()+1];
+	vector<DisassemblySegment> _segments[(int)DebugUtilities::GetLastCpuType()+1];
+	vector<DisassemblyRange> _segmentRanges[(int)DebugUtilities::GetLastCpuType()+1];
+	vector<uint32_t> _addressLines[(int)DebugUtilities::GetLastCpuType()+1];
+	uint32_t _scanStamp[(int)DebugUtilities::GetLastCpuType()+1] = {};
+	uint8_t _scanFlags[(int)DebugUtilities::GetLastCpuType()+1] = {};
 	bool _needDisassemble[(int)DebugUtilities::GetLastCpuType()+1];
 
 	void InitSource(SnesMemoryType type);
 	DisassemblerSource& GetSource(SnesMemoryType type);
 	void SetDisassembleFlag(CpuType type);
+	void MarkDirty(SnesMemoryType type, int32_t start, int32_t end);
+	bool IsDirty(SnesMemoryType type, int32_t start, int32_t end, uint32_t stamp);
+
+	static bool IsSameState(DisassemblerScanState &a, DisassemblerScanState &b);
+	bool IsSegmentUnchanged(CpuType type, MemoryMappings* mappings, int32_t start, int32_t end, DisassemblyRange* ranges, uint32_t rangeCount, bool disUnident, uint32_t stamp);
+	static bool IsReadOnlyMemory(SnesMemoryType type);
+	AddressInfo GetAbsoluteAddress(CpuType type, MemoryMappings* mappings, int32_t address);
+	void DisassembleSegment(CpuType type, MemoryMappings* mappings, int32_t start, int32_t end, uint8_t scanFlags, DisassemblerScanState &state, vector<DisassemblyResult> &results, vector<DisassemblyRange> &ranges);
+	void BuildLineIndex(CpuType type);
 
 public:
 	Disassembler(shared_ptr<Console> console, shared_ptr<CodeDataLogger> cdl, Debugger* debugger);
@@ -64,6 +117,8 @@ public:
 	uint32_t BuildCache(AddressInfo &addrInfo, uint8_t cpuFlags, CpuType type);
 	void ResetPrgCache();
 	void InvalidateCache(AddressInfo addrInfo, CpuType type);
+	void MarkDirty(AddressInfo addrInfo);
+	void MarkAllDirty();
 	void Disassemble(CpuType cpuType);
 
 	DisassemblyInfo GetDisassemblyInfo(AddressInfo &info, uint32_t cpuAddress, uint8_t cpuFlags, CpuType type);
@@ -3,6 +3,7 @@
 #include "DmaControllerTypes.h"
 #include "MemoryManager.h"
 #include "MessageManager.h"
+#include "BenchmarkCounters.h"
 #include "../Utilities/Serializer.h"
 
 static constexpr uint8_t _transferByteCount[8] = { 1, 2, 2, 4, 4, 4, 2, 4 };
@@ -346,6 +347,8 @@ bool DmaController::ProcessPendingTransfers()
 		return false;
 	}
 
+	BENCHMARK_SECTION(BenchmarkSection::Dma);
+
 	if(_dmaStartDelay) {
 		_dmaStartDelay = false;
 		return false;
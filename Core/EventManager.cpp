@@ -9,6 +9,7 @@
 #include "DebugBreakHelper.h"
 #include "DefaultVideoFilter.h"
 #include "BaseEventManager.h"
+#include "VideoFilterKernels.h"
 
 EventManager::EventManager(Debugger *debugger, Cpu *cpu, Ppu *ppu, MemoryManager *memoryManager, DmaController *dmaController)
 {
@@ -20,6 +21,9 @@ EventManager::EventManager(Debugger *debugger, Cpu *cpu, Ppu *ppu, MemoryManager
 
 	_ppuBuffer = new uint16_t[512 * 478];
 	memset(_ppuBuffer, 0, 512 * 478 * sizeof(uint16_t));
+
+	_debugEvents.reserve(0x10000);
+	_prevDebugEvents.reserve(0x10000);
 }
 
 EventManager::~EventManager()
@@ -76,9 +80,13 @@ DebugEventInfo EventManager::GetEvent(uint16_t scanline, uint16_t cycle, EventVi
 {
 	auto lock = _lock.AcquireSafe();
 
-	for(DebugEventInfo &evt : _sentEvents) {
-		if(evt.Cycle == cycle && evt.Scanline == scanline) {
-			return evt;
+	if(_filteredSnapshotId == _snapshotId) {
+		uint32_t bucket = std::min<uint32_t>(scanline, _scanlineCount);
+		for(uint32_t i = _scanlineEventStart[bucket], end = _scanlineEventStart[bucket + 1]; i < end; i++) {
+			DebugEventInfo &evt = _sentEvents[_scanlineEventIndexes[i]];
+			if(evt.Cycle == cycle && evt.Scanline == scanline) {
+				return evt;
+			}
 		}
 	}
 
@@ -96,121 +104,128 @@ uint32_t EventManager::GetEventCount(EventViewerDisplayOptions options)
 
 void EventManager::ClearFrameEvents()
 {
-	_prevDebugEvents = _debugEvents;
+	_prevDebugEvents.swap(_debugEvents);
 	_debugEvents.clear();
 }
 
-void EventManager::FilterEvents(EventViewerDisplayOptions &options)
-{
-	auto lock = _lock.AcquireSafe();
-	_sentEvents.clear();
-
-	vector<DebugEventInfo> events = _snapshot;
-	if(options.ShowPreviousFrameEvents && _snapshotScanline != 0) {
-		uint32_t key = (_snapshotScanline << 16) + _snapshotCycle;
-		for(DebugEventInfo &evt : _prevDebugEvents) {
-			uint32_t evtKey = (evt.Scanline << 16) + evt.Cycle;
-			if(evtKey > key) {
-				events.push_back(evt);
-			}
-		}
-	}
-
-	for(DebugEventInfo &evt : events) {
-		bool isWrite = evt.Operation.Type == MemoryOperationType::Write || evt.Operation.Type == MemoryOperationType::DmaWrite;
-		bool isDma = evt.Operation.Type == MemoryOperationType::DmaWrite || evt.Operation.Type == MemoryOperationType::DmaRead;
-		bool showEvent = false;
-		switch(evt.Type) {
-			case DebugEventType::Breakpoint: showEvent = options.ShowMarkedBreakpoints;break;
-			case DebugEventType::Irq: showEvent = options.ShowIrq; break;
-			case DebugEventType::Nmi: showEvent = options.ShowNmi; break;
-			case DebugEventType::Register:
-				if(isDma && !options.ShowDmaChannels[evt.DmaChannel & 0x07]) {
-					showEvent = false;
-					break;
-				}
-
-				uint16_t reg = evt.Operation.Address & 0xFFFF;
-				if(reg <= 0x213F) {
-					if(isWrite) {
-						if(reg >= 0x2101 && reg <= 0x2104) {
-							showEvent = options.ShowPpuRegisterOamWrites;
-						} else if(reg >= 0x2105 && reg <= 0x210C) {
-							showEvent = options.ShowPpuRegisterBgOptionWrites;
-						} else if(reg >= 0x210D && reg <= 0x2114) {
-							showEvent = options.ShowPpuRegisterBgScrollWrites;
-						} else if(reg >= 0x2115 && reg <= 0x2119) {
-							showEvent = options.ShowPpuRegisterVramWrites;
-						} else if(reg >= 0x211A && reg <= 0x2120) {
-							showEvent = options.ShowPpuRegisterMode7Writes;
-						} else if(reg >= 0x2121 && reg <= 0x2122) {
-							showEvent = options.ShowPpuRegisterCgramWrites;
-						} else if(reg >= 0x2123 && reg <= 0x212B) {
-							showEvent = options.ShowPpuRegisterWindowWrites;
-						} else {
-							showEvent = options.ShowPpuRegisterOtherWrites;
-						}
-					} else {
-						showEvent = options.ShowPpuRegisterReads;
-					}
-				} else if(reg <= 0x217F) {
-					showEvent = isWrite ? options.ShowApuRegisterWrites : options.ShowApuRegisterReads;
-				} else if(reg <= 0x2183) {
-					showEvent = isWrite ? options.ShowWorkRamRegisterWrites : options.ShowWorkRamRegisterReads;
-				} else if(reg >= 0x4000) {
-					showEvent = isWrite ? options.ShowCpuRegisterWrites : options.ShowCpuRegisterReads;
-				}
-				break;
-		}
-
-		if(showEvent) {
-			_sentEvents.push_back(evt);
-		}
-	}
-}
-
-void EventManager::DrawEvent(DebugEventInfo &evt, bool drawBackground, uint32_t *buffer, EventViewerDisplayOptions &options)
+bool EventManager::GetEventColor(DebugEventInfo &evt, EventViewerDisplayOptions &options, uint32_t &color)
 {
 	bool isWrite = evt.Operation.Type == MemoryOperationType::Write || evt.Operation.Type == MemoryOperationType::DmaWrite;
-	uint32_t color = 0;
+	bool isDma = evt.Operation.Type == MemoryOperationType::DmaWrite || evt.Operation.Type == MemoryOperationType::DmaRead;
 	switch(evt.Type) {
-		case DebugEventType::Breakpoint: color = options.BreakpointColor; break;
-		case DebugEventType::Irq: color = options.IrqColor; break;
-		case DebugEventType::Nmi: color = options.NmiColor; break;
+		case DebugEventType::Breakpoint: color = options.BreakpointColor; return options.ShowMarkedBreakpoints;
+		case DebugEventType::Irq: color = options.IrqColor; return options.ShowIrq;
+		case DebugEventType::Nmi: color = options.NmiColor; return options.ShowNmi;
 		case DebugEventType::Register:
+			if(isDma && !options.ShowDmaChannels[evt.DmaChannel & 0x07]) {
+				return false;
+			}
+
 			uint16_t reg = evt.Operation.Address & 0xFFFF;
 			if(reg <= 0x213F) {
 				if(isWrite) {
 					if(reg >= 0x2101 && reg <= 0x2104) {
 						color = options.PpuRegisterWriteOamColor;
+						return options.ShowPpuRegisterOamWrites;
 					} else if(reg >= 0x2105 && reg <= 0x210C) {
 						color = options.PpuRegisterWriteBgOptionColor;
+						return options.ShowPpuRegisterBgOptionWrites;
 					} else if(reg >= 0x210D && reg <= 0x2114) {
 						color = options.PpuRegisterWriteBgScrollColor;
+						return options.ShowPpuRegisterBgScrollWrites;
 					} else if(reg >= 0x2115 && reg <= 0x2119) {
 						color = options.PpuRegisterWriteVramColor;
+						return options.ShowPpuRegisterVramWrites;
 					} else if(reg >= 0x211A && reg <= 0x2120) {
 						color = options.PpuRegisterWriteMode7Color;
+						return options.ShowPpuRegisterMode7Writes;
 					} else if(reg >= 0x2121 && reg <= 0x2122) {
 						color = options.PpuRegisterWriteCgramColor;
+						return options.ShowPpuRegisterCgramWrites;
 					} else if(reg >= 0x2123 && reg <= 0x212B) {
 						color = options.PpuRegisterWriteWindowColor;
+						return options.ShowPpuRegisterWindowWrites;
 					} else {
 						color = options.PpuRegisterWriteOtherColor;
+						return options.ShowPpuRegisterOtherWrites;
 					}
 				} else {
 					color = options.PpuRegisterReadColor;
+					return options.ShowPpuRegisterReads;
 				}
 			} else if(reg <= 0x217F) {
 				color = isWrite ? options.ApuRegisterWriteColor : options.ApuRegisterReadColor;
+				return isWrite ? options.ShowApuRegisterWrites : options.ShowApuRegisterReads;
 			} else if(reg <= 0x2183) {
 				color = isWrite ? options.WorkRamRegisterWriteColor : options.WorkRamRegisterReadColor;
+				return isWrite ? options.ShowWorkRamRegisterWrites : options.ShowWorkRamRegisterReads;
 			} else if(reg >= 0x4000) {
 				color = isWrite ? options.CpuRegisterWriteColor : options.CpuRegisterReadColor;
+				return isWrite ? options.ShowCpuRegisterWrites : options.ShowCpuRegisterReads;
 			}
 			break;
 	}
+	return false;
+}
+
+static uint64_t HashValue(uint64_t hash, uint64_t value)
+{
+	return (hash ^ value) * 0x100000001B3;
+}
+
+void EventManager::FilterEvents(EventViewerDisplayOptions &options)
+{
+	auto lock = _lock.AcquireSafe();
+	if(_filteredSnapshotId == _snapshotId && memcmp(&_filterOptions, &options, sizeof(options)) == 0) {
+		//Nothing changed since the last call
+		return;
+	}
+	_filteredSnapshotId = _snapshotId;
+	_filterOptions = options;
+
+	_sentEvents.clear();
+	_sentColors.clear();
+
+	auto addEvent = [this, &options](DebugEventInfo &evt) {
+		uint32_t color = 0;
+		if(GetEventColor(evt, options, color)) {
+			_sentEvents.push_back(evt);
+			_sentColors.push_back(color);
+		}
+	};
+
+	for(DebugEventInfo &evt : _snapshot) {
+		addEvent(evt);
+	}
+
+	if(options.ShowPreviousFrameEvents) {
+		for(DebugEventInfo &evt : _prevFrameSnapshot) {
+			addEvent(evt);
+		}
+	}
+
+	//Bucket the events by scanline (events past the last scanline are drawn on it), keeping their order
+	uint32_t bucketCount = _scanlineCount + 1;
+	_scanlineEventStart.assign(bucketCount + 1, 0);
+	for(DebugEventInfo &evt : _sentEvents) {
+		_scanlineEventStart[std::min<uint32_t>(evt.Scanline, _scanlineCount) + 1]++;
+	}
+	for(uint32_t i = 0; i < bucketCount; i++) {
+		_scanlineEventStart[i + 1] += _scanlineEventStart[i];
+	}
 
+	vector<uint32_t> pos(_scanlineEventStart.begin(), _scanlineEventStart.end() - 1);
+	_scanlineEventIndexes.resize(_sentEvents.size());
+	_scanlineEventHashes.assign(bucketCount, 0);
+	for(uint32_t i = 0; i < (uint32_t)_sentEvents.size(); i++) {
+		uint32_t bucket = std::min<uint32_t>(_sentEvents[i].Scanline, _scanlineCount);
+		_scanlineEventIndexes[pos[bucket]++] = i;
+		_scanlineEventHashes[bucket] = HashValue(HashValue(_scanlineEventHashes[bucket], _sentEvents[i].Cycle), _sentColors[i]);
+	}
+}
+
+void EventManager::DrawEvent(DebugEventInfo &evt, uint32_t color, bool drawBackground, uint32_t *buffer, uint32_t firstRow, uint32_t lastRow)
+{
 	if(drawBackground){
 		color = 0xFF000000 | ((color >> 1) & 0x7F7F7F);
 	} else {
@@ -224,10 +239,13 @@ void EventManager::DrawEvent(DebugEventInfo &evt, bool drawBackground, uint32_t
 	uint32_t y = std::min<uint32_t>(evt.Scanline * 2, _scanlineCount * 2);
 	uint32_t x = evt.Cycle / 2;
 
+	//Only draw within the rows that are being refreshed
+	int32_t minPos = firstRow * EventManager::ScanlineWidth;
+	int32_t maxPos = (lastRow + 1) * EventManager::ScanlineWidth;
 	for(int i = iMin; i <= iMax; i++) {
 		for(int j = jMin; j <= jMax; j++) {
 			int32_t pos = (y + i) * EventManager::ScanlineWidth + x + j;
-			if(pos < 0 || pos >= EventManager::ScanlineWidth * (int)_scanlineCount * 2) {
+			if(pos < minPos || pos >= maxPos) {
 				continue;
 			}
 			buffer[pos] = color;
@@ -258,12 +276,91 @@ uint32_t EventManager::TakeEventSnapshot(EventViewerDisplayOptions options)
 	}
 
 	_snapshot = _debugEvents;
+	_snapshotId++;
 	_snapshotScanline = scanline;
 	_snapshotCycle = cycle;
+
+	//Keep the part of the previous frame that hasn't been overwritten by the current frame yet
+	_prevFrameSnapshot.clear();
+	if(scanline != 0) {
+		uint32_t key = (scanline << 16) + cycle;
+		for(DebugEventInfo &evt : _prevDebugEvents) {
+			uint32_t evtKey = (evt.Scanline << 16) + evt.Cycle;
+			if(evtKey > key) {
+				_prevFrameSnapshot.push_back(evt);
+			}
+		}
+	}
 	_scanlineCount = _ppu->GetVblankEndScanline() + 1;
 	return _scanlineCount;
 }
 
+uint64_t EventManager::GetScanlineSignature(uint32_t scanline, uint16_t *src, uint32_t ppuScanlineCount, uint32_t nmiScanline)
+{
+	//Covers everything drawn on the scanline: the PPU output, the markers and the events on it and on the 2 scanlines
+	//before/after it (event outlines overlap the adjacent scanlines, and wrap around to the next/previous row at the edges)
+	uint64_t hash = 0xCBF29CE484222325;
+	for(int32_t i = (int32_t)scanline - 2; i <= (int32_t)scanline + 2; i++) {
+		hash = HashValue(hash, i >= 0 && i <= (int32_t)_scanlineCount ? _scanlineEventHashes[i] : 0);
+	}
+	hash = HashValue(hash, (scanline == nmiScanline ? 1 : 0) | (scanline == (uint32_t)_snapshotScanline ? 2 : 0));
+
+	if(scanline >= 1 && scanline <= ppuScanlineCount) {
+		uint32_t pixelCount = _useHighResOutput ? 1024 : 256;
+		uint16_t *row = src + (scanline - 1) * pixelCount;
+		for(uint32_t i = 0; i < pixelCount; i += 4) {
+			uint64_t value;
+			memcpy(&value, row + i, sizeof(value));
+			hash = HashValue(hash, value);
+		}
+	}
+	return hash;
+}
+
+void EventManager::DrawScanlines(uint32_t firstScanline, uint32_t lastScanline, uint16_t *src, uint32_t ppuScanlineCount, uint32_t nmiScanline)
+{
+	uint32_t *buffer = _displayBuffer.data();
+	uint32_t firstRow = firstScanline * 2;
+	uint32_t lastRow = lastScanline * 2 + 1;
+
+	std::fill(buffer + firstRow * EventManager::ScanlineWidth, buffer + (lastRow + 1) * EventManager::ScanlineWidth, 0xFF555555);
+
+	//The PPU output starts on the second scanline
+	uint32_t rowBuffer[256];
+	for(uint32_t scanline = std::max<uint32_t>(firstScanline, 1); scanline <= std::min(lastScanline, ppuScanlineCount); scanline++) {
+		uint32_t *dst = buffer + scanline * 2 * EventManager::ScanlineWidth + 22 * 2;
+		if(_useHighResOutput) {
+			uint16_t *row = src + (scanline - 1) * 1024;
+			VideoFilterKernels::ConvertRgb555ToArgb(row, dst, 512, 255);
+			VideoFilterKernels::ConvertRgb555ToArgb(row + 512, dst + EventManager::ScanlineWidth, 512, 255);
+		} else {
+			VideoFilterKernels::ConvertRgb555ToArgb(src + (scanline - 1) * 256, rowBuffer, 256, 255);
+			VideoFilterKernels::ScaleRow(rowBuffer, dst, 256, 2);
+			memcpy(dst + EventManager::ScanlineWidth, dst, 512 * sizeof(uint32_t));
+		}
+	}
+
+	constexpr uint32_t nmiColor = 0xFF55FFFF;
+	constexpr uint32_t currentScanlineColor = 0xFFFFFF55;
+	if(nmiScanline >= firstScanline && nmiScanline <= lastScanline) {
+		std::fill(buffer + nmiScanline * 2 * EventManager::ScanlineWidth, buffer + (nmiScanline * 2 + 2) * EventManager::ScanlineWidth, nmiColor);
+	}
+	uint32_t snapshotScanline = (uint32_t)_snapshotScanline;
+	if(snapshotScanline != 0 && snapshotScanline >= firstScanline && snapshotScanline <= lastScanline) {
+		std::fill(buffer + snapshotScanline * 2 * EventManager::ScanlineWidth, buffer + (snapshotScanline * 2 + 2) * EventManager::ScanlineWidth, currentScanlineColor);
+	}
+
+	//Outlines of the events on the adjacent scanlines overlap these scanlines' rows
+	uint32_t firstBucket = firstScanline > 2 ? firstScanline - 2 : 0;
+	uint32_t endBucket = std::min(lastScanline + 3, _scanlineCount + 1);
+	for(int pass = 0; pass < 2; pass++) {
+		for(uint32_t i = _scanlineEventStart[firstBucket], end = _scanlineEventStart[endBucket]; i < end; i++) {
+			uint32_t index = _scanlineEventIndexes[i];
+			DrawEvent(_sentEvents[index], _sentColors[index], pass == 0, buffer, firstRow, lastRow);
+		}
+	}
+}
+
 void EventManager::GetDisplayBuffer(uint32_t *buffer, uint32_t bufferSize, EventViewerDisplayOptions options)
 {
 	auto lock = _lock.AcquireSafe();
@@ -272,38 +369,39 @@ void EventManager::GetDisplayBuffer(uint32_t *buffer, uint32_t bufferSize, Event
 		return;
 	}
 
-	for(int i = 0; i < EventManager::ScanlineWidth * (int)_scanlineCount * 2; i++) {
-		buffer[i] = 0xFF555555;
+	FilterEvents(options);
+
+	uint32_t pixelCount = EventManager::ScanlineWidth * _scanlineCount * 2;
+	bool fullRefresh = _displayBuffer.size() != pixelCount || _displayOverscanMode != _overscanMode || _displayHighResOutput != _useHighResOutput;
+	if(fullRefresh) {
+		_displayBuffer.resize(pixelCount);
+		_scanlineSignatures.assign(_scanlineCount, 0);
+		_displayOverscanMode = _overscanMode;
+		_displayHighResOutput = _useHighResOutput;
 	}
 
 	//Skip the first 7 blank lines in the buffer when overscan mode is off
 	uint16_t *src = _ppuBuffer + (_overscanMode ? 0 : (_useHighResOutput ? (512 * 14) : (256 * 7)));
-
-	for(uint32_t y = 0, len = _overscanMode ? 239*2 : 224*2; y < len; y++) {
-		for(uint32_t x = 0; x < 512; x++) {
-			int srcOffset = _useHighResOutput ? ((y << 9) | x) : (((y >> 1) << 8) | (x >> 1));
-			buffer[(y + 2)*EventManager::ScanlineWidth + x + 22*2] = DefaultVideoFilter::ToArgb(src[srcOffset]);
+	uint32_t ppuScanlineCount = _overscanMode ? 239 : 224;
+	uint32_t nmiScanline = _overscanMode ? 240 : 225;
+
+	//Redraw each run of scanlines whose content changed since the last call
+	int32_t dirtyStart = -1;
+	for(uint32_t scanline = 0; scanline <= _scanlineCount; scanline++) {
+		bool dirty = false;
+		if(scanline < _scanlineCount) {
+			uint64_t signature = GetScanlineSignature(scanline, src, ppuScanlineCount, nmiScanline);
+			dirty = fullRefresh || signature != _scanlineSignatures[scanline];
+			_scanlineSignatures[scanline] = signature;
 		}
-	}
 
-	constexpr uint32_t nmiColor = 0xFF55FFFF;
-	constexpr uint32_t currentScanlineColor = 0xFFFFFF55;
-	int nmiScanline = (_overscanMode ? 240 : 225) * 2 * EventManager::ScanlineWidth;
-	uint32_t scanlineOffset = _snapshotScanline * 2 * EventManager::ScanlineWidth;
-	for(int i = 0; i < EventManager::ScanlineWidth; i++) {
-		buffer[nmiScanline + i] = nmiColor;
-		buffer[nmiScanline + EventManager::ScanlineWidth + i] = nmiColor;
-		if(_snapshotScanline != 0) {
-			buffer[scanlineOffset + i] = currentScanlineColor;
-			buffer[scanlineOffset + EventManager::ScanlineWidth + i] = currentScanlineColor;
+		if(dirty && dirtyStart < 0) {
+			dirtyStart = scanline;
+		} else if(!dirty && dirtyStart >= 0) {
+			DrawScanlines(dirtyStart, scanline - 1, src, ppuScanlineCount, nmiScanline);
+			dirtyStart = -1;
 		}
 	}
 
-	FilterEvents(options);
-	for(DebugEventInfo &evt : _sentEvents) {
-		DrawEvent(evt, true, buffer, options);
-	}
-	for(DebugEventInfo &evt : _sentEvents) {
-		DrawEvent(evt, false, buffer, options);
-	}
+	memcpy(buffer, _displayBuffer.data(), pixelCount * sizeof(uint32_t));
 }
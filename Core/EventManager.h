@@ -24,11 +24,22 @@ private:
 	MemoryManager* _memoryManager;
 	DmaController *_dmaController;
 	Debugger *_debugger;
+	//The current and previous frame's events - the buffers are swapped at the end of each frame, so they keep their capacity
 	vector<DebugEventInfo> _debugEvents;
 	vector<DebugEventInfo> _prevDebugEvents;
+
+	//Filtered events (and their color), bucketed by scanline - only rebuilt when the snapshot or the display options change
 	vector<DebugEventInfo> _sentEvents;
+	vector<uint32_t> _sentColors;
+	vector<uint32_t> _scanlineEventStart;
+	vector<uint32_t> _scanlineEventIndexes;
+	vector<uint64_t> _scanlineEventHashes;
+	EventViewerDisplayOptions _filterOptions = {};
+	uint32_t _snapshotId = 1;
+	uint32_t _filteredSnapshotId = 0;
 	
 	vector<DebugEventInfo> _snapshot;
+	vector<DebugEventInfo> _prevFrameSnapshot;
 	int16_t _snapshotScanline = -1;
 	uint16_t _snapshotCycle = 0;
 	SimpleLock _lock;
@@ -38,8 +49,17 @@ private:
 	uint32_t _scanlineCount = 262;
 	uint16_t *_ppuBuffer = nullptr;
 
-	void DrawEvent(DebugEventInfo &evt, bool drawBackground, uint32_t *buffer, EventViewerDisplayOptions &options);
+	//Last rendered viewer image, only the scanlines whose signature changed are redrawn
+	vector<uint32_t> _displayBuffer;
+	vector<uint64_t> _scanlineSignatures;
+	bool _displayOverscanMode = false;
+	bool _displayHighResOutput = false;
+
+	bool GetEventColor(DebugEventInfo &evt, EventViewerDisplayOptions &options, uint32_t &color);
+	void DrawEvent(DebugEventInfo &evt, uint32_t color, bool drawBackground, uint32_t *buffer, uint32_t firstRow, uint32_t lastRow);
 	void FilterEvents(EventViewerDisplayOptions &options);
+	uint64_t GetScanlineSignature(uint32_t scanline, uint16_t *src, uint32_t ppuScanlineCount, uint32_t nmiScanline);
+	void DrawScanlines(uint32_t firstScanline, uint32_t lastScanline, uint16_t *src, uint32_t ppuScanlineCount, uint32_t nmiScanline);
 
 public:
 	EventManager(Debugger *debugger, Cpu *cpu, Ppu *ppu, MemoryManager *memoryManager, DmaController *dmaController);
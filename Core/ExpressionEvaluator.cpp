@@ -471,9 +471,29 @@ bool ExpressionEvaluator::ToRpn(string expression, ExpressionData &data)
 		opStack.pop();
 	}
 
+	data.UsesState = CheckStateUsage(data);
 	return true;
 }
 
+bool ExpressionEvaluator::CheckStateUsage(ExpressionData &data)
+{
+	for(int64_t token : data.RpnQueue) {
+		if(token >= EvalValues::RegA && token < EvalValues::FirstLabelIndex) {
+			switch(token) {
+				case EvalValues::Value:
+				case EvalValues::Address:
+				case EvalValues::IsWrite:
+				case EvalValues::IsRead:
+					break;
+
+				default:
+					return true;
+			}
+		}
+	}
+	return false;
+}
+
 int32_t ExpressionEvaluator::Evaluate(ExpressionData &data, DebugState &state, EvalResultType &resultType, MemoryOperationInfo &operationInfo)
 {
 	if(data.RpnQueue.empty()) {
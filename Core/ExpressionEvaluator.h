@@ -144,6 +144,9 @@ struct ExpressionData
 {
 	std::vector<int64_t> RpnQueue;
 	std::vector<string> Labels;
+
+	//False when the expression only uses constants, memory reads and the operation's value/address/type (no need to capture the debug state)
+	bool UsesState = true;
 };
 
 class ExpressionEvaluator
@@ -174,6 +177,7 @@ private:
 	string GetNextToken(string expression, size_t &pos, ExpressionData &data, bool &success, bool previousTokenIsOp);
 	bool ProcessSpecialOperator(EvalOperators evalOp, std::stack<EvalOperators> &opStack, std::stack<int> &precedenceStack, vector<int64_t> &outputQueue);
 	bool ToRpn(string expression, ExpressionData &data);
+	bool CheckStateUsage(ExpressionData &data);
 	int32_t PrivateEvaluate(string expression, DebugState &state, EvalResultType &resultType, MemoryOperationInfo &operationInfo, bool &success);
 	ExpressionData* PrivateGetRpnList(string expression, bool& success);
 
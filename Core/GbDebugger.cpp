@@ -5,6 +5,7 @@
 #include "Gameboy.h"
 #include "TraceLogger.h"
 #include "CallstackManager.h"
+#include "Profiler.h"
 #include "BreakpointManager.h"
 #include "MemoryManager.h"
 #include "Debugger.h"
@@ -32,7 +33,7 @@ GbDebugger::GbDebugger(Debugger* debugger)
 	_codeDataLogger.reset(new CodeDataLogger(_gameboy->DebugGetMemorySize(SnesMemoryType::GbPrgRom), CpuType::Gameboy));
 
 	_eventManager.reset(new GbEventManager(debugger, _gameboy->GetCpu(), _gameboy->GetPpu()));
-	_callstackManager.reset(new CallstackManager(debugger));
+	_callstackManager.reset(new CallstackManager(debugger, CpuType::Gameboy));
 	_breakpointManager.reset(new BreakpointManager(debugger, CpuType::Gameboy, _eventManager.get()));
 	_step.reset(new StepRequest());
 	_assembler.reset(new GbAssembler(debugger->GetLabelManager()));
@@ -49,7 +50,9 @@ GbDebugger::~GbDebugger()
 
 void GbDebugger::Reset()
 {
-	_callstackManager.reset(new CallstackManager(_debugger));
+	shared_ptr<CallstackManager> prevCallstackManager = _callstackManager;
+	_callstackManager.reset(new CallstackManager(_debugger, CpuType::Gameboy));
+	_callstackManager->GetProfiler()->CopyMode(prevCallstackManager->GetProfiler());
 	_prevOpCode = 0;
 }
 
@@ -83,14 +86,18 @@ void GbDebugger::ProcessRead(uint16_t addr, uint8_t value, MemoryOperationType t
 			//CALL and RST, and PC doesn't match the next instruction, so the call was (probably) done
 			uint8_t opSize = DisassemblyInfo::GetOpSize(_prevOpCode, 0, CpuType::Gameboy);
 			uint16_t returnPc = _prevProgramCounter + opSize;
-			AddressInfo src = _gameboy->GetAbsoluteAddress(_prevProgramCounter);
 			AddressInfo ret = _gameboy->GetAbsoluteAddress(returnPc);
-			_callstackManager->Push(src, _prevProgramCounter, addressInfo, gbState.PC, ret, returnPc, StackFrameFlags::None);
+			_callstackManager->Push(_prevProgramCounter, addressInfo, gbState.PC, ret, returnPc, StackFrameFlags::None);
 		} else if(GameboyDisUtils::IsReturnInstruction(_prevOpCode) && gbState.PC != _prevProgramCounter + GameboyDisUtils::GetOpSize(_prevOpCode)) {
 			//RET used, and PC doesn't match the next instruction, so the ret was (probably) taken
 			_callstackManager->Pop(addressInfo, gbState.PC);
 		}
 
+		Profiler* profiler = _callstackManager->GetProfiler();
+		if(profiler->IsSampling()) {
+			profiler->ProcessInstruction(addressInfo, _gameboy->GetCycleCount());
+		}
+
 		if(_step->BreakAddress == (int32_t)gbState.PC && GameboyDisUtils::IsReturnInstruction(_prevOpCode)) {
 			//RET/RETI found, if we're on the expected return address, break immediately (for step over/step out)
 			_step->StepCount = 0;
@@ -209,10 +216,9 @@ void GbDebugger::Step(int32_t stepCount, StepType type)
 
 void GbDebugger::ProcessInterrupt(uint32_t originalPc, uint32_t currentPc)
 {
-	AddressInfo src = _gameboy->GetAbsoluteAddress(_prevProgramCounter);
 	AddressInfo ret = _gameboy->GetAbsoluteAddress(originalPc);
 	AddressInfo dest = _gameboy->GetAbsoluteAddress(currentPc);
-	_callstackManager->Push(src, _prevProgramCounter, dest, currentPc, ret, originalPc, StackFrameFlags::Irq);
+	_callstackManager->Push(_prevProgramCounter, dest, currentPc, ret, originalPc, StackFrameFlags::Irq);
 	_eventManager->AddEvent(DebugEventType::Irq);
 }
 
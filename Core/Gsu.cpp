@@ -637,6 +637,11 @@ GsuState Gsu::GetState()
 	return _state;
 }
 
+uint64_t Gsu::GetCycleCount()
+{
+	return _state.CycleCount;
+}
+
 MemoryMappings* Gsu::GetMemoryMappings()
 {
 	return &_mappings;
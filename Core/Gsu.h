@@ -167,6 +167,7 @@ public:
 	void Serialize(Serializer &s) override;
 
 	GsuState GetState();
+	uint64_t GetCycleCount();
 	MemoryMappings* GetMemoryMappings();
 	uint8_t* DebugGetWorkRam();
 	uint32_t DebugGetWorkRamSize();
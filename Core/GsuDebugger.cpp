@@ -14,6 +14,7 @@
 #include "EmuSettings.h"
 #include "MemoryAccessCounter.h"
 #include "CodeDataLogger.h"
+#include "Profiler.h"
 
 GsuDebugger::GsuDebugger(Debugger* debugger)
 {
@@ -26,6 +27,8 @@ GsuDebugger::GsuDebugger(Debugger* debugger)
 	_memoryManager = debugger->GetConsole()->GetMemoryManager().get();
 	_settings = debugger->GetConsole()->GetSettings().get();
 
+	//The GSU has no call/return instructions, its callstack is only used by the sampling profiler (flat profile)
+	_callstackManager.reset(new CallstackManager(debugger, CpuType::Gsu));
 	_breakpointManager.reset(new BreakpointManager(debugger, CpuType::Gsu));
 	_step.reset(new StepRequest());
 }
@@ -64,6 +67,11 @@ void GsuDebugger::ProcessRead(uint32_t addr, uint8_t value, MemoryOperationType
 			}
 		}
 
+		Profiler* profiler = _callstackManager->GetProfiler();
+		if(profiler->IsSampling()) {
+			profiler->ProcessInstruction(addressInfo, _gsu->GetCycleCount());
+		}
+
 		_prevOpCode = value;
 		_prevProgramCounter = addr;
 
@@ -116,4 +124,9 @@ void GsuDebugger::Step(int32_t stepCount, StepType type)
 BreakpointManager* GsuDebugger::GetBreakpointManager()
 {
 	return _breakpointManager.get();
+}
+
+shared_ptr<CallstackManager> GsuDebugger::GetCallstackManager()
+{
+	return _callstackManager;
 }
\ No newline at end of file
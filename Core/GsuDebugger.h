@@ -11,6 +11,7 @@ class Gsu;
 class MemoryAccessCounter;
 class MemoryManager;
 class BreakpointManager;
+class CallstackManager;
 class EmuSettings;
 
 class GsuDebugger final : public IDebugger
@@ -24,6 +25,7 @@ class GsuDebugger final : public IDebugger
 	Gsu* _gsu;
 	EmuSettings* _settings;
 
+	shared_ptr<CallstackManager> _callstackManager;
 	unique_ptr<BreakpointManager> _breakpointManager;
 	unique_ptr<StepRequest> _step;
 
@@ -41,4 +43,5 @@ public:
 	void Step(int32_t stepCount, StepType type);
 
 	BreakpointManager* GetBreakpointManager();
+	shared_ptr<CallstackManager> GetCallstackManager();
 };
\ No newline at end of file
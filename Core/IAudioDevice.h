@@ -7,6 +7,8 @@ struct AudioStatistics
 	double AverageLatency = 0;
 	uint32_t BufferUnderrunEventCount = 0;
 	uint32_t BufferSize = 0;
+	double MixerLatency = 0;
+	uint32_t MixerOverrunCount = 0;
 };
 
 class IAudioDevice
@@ -22,4 +24,7 @@ public:
 	virtual void SetAudioDevice(string deviceName) = 0;
 
 	virtual AudioStatistics GetStatistics() = 0;
+
+	//Devices that must receive their samples on the emulation thread (e.g libretro) bypass the mixer thread
+	virtual bool RequiresSynchronousOutput() { return false; }
 };
\ No newline at end of file
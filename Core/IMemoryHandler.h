@@ -20,6 +20,9 @@ public:
 	virtual void PeekBlock(uint32_t addr, uint8_t *output) = 0;
 	virtual void Write(uint32_t addr, uint8_t value) = 0;
 
+	//Returns the start of this 4KB page, if reads can be done directly from memory (without calling Read)
+	virtual uint8_t* GetDirectReadPointer() { return nullptr; }
+
 	__forceinline SnesMemoryType GetMemoryType()
 	{
 		return _memoryType;
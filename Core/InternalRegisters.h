@@ -36,6 +36,7 @@ public:
 	void ProcessAutoJoypadRead();
 
 	__forceinline void ProcessIrqCounters();
+	__forceinline bool ProcessIrqCounters(uint16_t firstHClock, uint16_t lastHClock);
 
 	uint8_t GetIoPortOutput();
 	void SetNmiFlag(bool nmiFlag);
@@ -78,4 +79,34 @@ void InternalRegisters::ProcessIrqCounters()
 	}
 	_irqLevel = irqLevel;
 	_cpu->SetNmiFlag(_state.EnableNmi & _nmiFlag);
-}
\ No newline at end of file
+}
+
+bool InternalRegisters::ProcessIrqCounters(uint16_t firstHClock, uint16_t lastHClock)
+{
+	//Processes all the IRQ counter updates between the 2 H clock values at once
+	//Returns false (and does nothing) if the IRQ state might change during that period
+	if(_needIrq > 0) {
+		return false;
+	}
+
+	bool irqLevel;
+	if(!_state.EnableHorizontalIrq && !_state.EnableVerticalIrq) {
+		irqLevel = false;
+	} else if(_state.EnableVerticalIrq && _ppu->GetRealScanline() != _state.VerticalTimer) {
+		irqLevel = false;
+	} else if(!_state.EnableHorizontalIrq) {
+		irqLevel = true;
+	} else if(!_irqLevel && (_state.HorizontalTimer > 339 || _state.HorizontalTimer < Ppu::GetCycle(firstHClock) || _state.HorizontalTimer > Ppu::GetCycle(lastHClock))) {
+		irqLevel = false;
+	} else {
+		//H timer might match one of the PPU cycles
+		return false;
+	}
+
+	if(irqLevel != _irqLevel) {
+		return false;
+	}
+
+	_cpu->SetNmiFlag(_state.EnableNmi & _nmiFlag);
+	return true;
+}
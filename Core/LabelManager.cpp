@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "LabelManager.h"
 #include "Debugger.h"
+#include "Disassembler.h"
 #include "DebugUtilities.h"
 #include "DebugBreakHelper.h"
 
@@ -14,6 +15,11 @@ void LabelManager::ClearLabels()
 	DebugBreakHelper helper(_debugger);
 	_codeLabels.clear();
 	_codeLabelReverseLookup.clear();
+
+	shared_ptr<Disassembler> disassembler = _debugger->GetDisassembler();
+	if(disassembler) {
+		disassembler->MarkAllDirty();
+	}
 }
 
 void LabelManager::SetLabel(uint32_t address, SnesMemoryType memType, string label, string comment)
@@ -40,6 +46,11 @@ void LabelManager::SetLabel(uint32_t address, SnesMemoryType memType, string lab
 		_codeLabels.emplace(key, labelInfo);
 		_codeLabelReverseLookup.emplace(label, key);
 	}
+
+	shared_ptr<Disassembler> disassembler = _debugger->GetDisassembler();
+	if(disassembler) {
+		disassembler->MarkDirty({ (int32_t)address, memType });
+	}
 }
 
 int64_t LabelManager::GetLabelKey(uint32_t absoluteAddr, SnesMemoryType memType)
@@ -109,19 +109,24 @@ void LuaScriptingContext::UnregisterEventCallback(EventType type, int reference)
 
 void LuaScriptingContext::InternalCallMemoryCallback(uint32_t addr, uint8_t &value, CallbackType type, CpuType cpuType)
 {
-	if(_callbacks[(int)type].empty()) {
-		return;
-	}
+	uint32_t page = GetCallbackPage(addr);
+	bool initDone = false;
 
-	_timer.Reset();
-	_context = this;
-	lua_sethook(_lua, LuaScriptingContext::ExecutionCountHook, LUA_MASKCOUNT, 1000); 
-	LuaApi::SetContext(this);
-	for(MemoryCallback &callback: _callbacks[(int)type]) {
+	//Callbacks can be registered/unregistered by the Lua functions, so the index is re-read on each iteration
+	for(uint32_t i = _pageOffsets[(int)type][page]; i < _pageOffsets[(int)type][page + 1] && i < _pageCallbacks[(int)type].size(); i++) {
+		MemoryCallback callback = _callbacks[(int)type][_pageCallbacks[(int)type][i]];
 		if(callback.Type != cpuType || addr < callback.StartAddress || addr > callback.EndAddress) {
 			continue;
 		}
 
+		if(!initDone) {
+			_timer.Reset();
+			_context = this;
+			lua_sethook(_lua, LuaScriptingContext::ExecutionCountHook, LUA_MASKCOUNT, 1000); 
+			LuaApi::SetContext(this);
+			initDone = true;
+		}
+
 		int top = lua_gettop(_lua);
 		lua_rawgeti(_lua, LUA_REGISTRYINDEX, callback.Reference);
 		lua_pushinteger(_lua, addr);
@@ -23,24 +23,62 @@ MemoryAccessCounter::MemoryAccessCounter(Debugger* debugger, Console *console)
 
 	for(int i = (int)SnesMemoryType::PrgRom; i < (int)SnesMemoryType::Register; i++) {
 		uint32_t memSize = _debugger->GetMemoryDumper()->GetMemorySize((SnesMemoryType)i);
-		_counters[i].reserve(memSize);
-		for(uint32_t j = 0; j < memSize; j++) {
-			_counters[i].push_back({ j });
-		}
+		_pages[i].resize((memSize + PageMask) >> PageShift);
 	}
 }
 
-bool MemoryAccessCounter::IsAddressUninitialized(AddressInfo& addressInfo)
+MemoryAccessCounter::CounterPage* MemoryAccessCounter::GetPage(AddressInfo &addressInfo)
 {
-	if(!DebugUtilities::IsRomMemory(addressInfo.Type)) {
-		return _counters[(int)addressInfo.Type][addressInfo.Address].WriteCount == 0;
+	unique_ptr<CounterPage> &page = _pages[(int)addressInfo.Type][addressInfo.Address >> PageShift];
+	if(!page) {
+		page.reset(new CounterPage());
 	}
-	return false;
+	return page.get();
+}
+
+uint32_t MemoryAccessCounter::GetStamp(uint64_t masterClock)
+{
+	uint64_t stamp = masterClock - _stampBase;
+	if(stamp > 0xFFFFFFFF) {
+		//Master clock is out of the range the 32-bit stamps can represent (or went back, e.g after loading a state)
+		SetStampBase(masterClock > 0x80000000 ? masterClock - 0x80000000 : 0);
+		stamp = masterClock - _stampBase;
+	}
+	return (uint32_t)stamp;
+}
+
+void MemoryAccessCounter::SetStampBase(uint64_t stampBase)
+{
+	//Stamps older than the new base are clamped to it (the oldest stamp that can be represented)
+	auto rebase = [=](AccessCount &count) {
+		if(count.Stamp) {
+			uint64_t clock = _stampBase + count.Stamp;
+			if(clock <= stampBase) {
+				count.Stamp = 1;
+			} else {
+				count.Stamp = (uint32_t)std::min<uint64_t>(clock - stampBase, 0xFFFFFFFF);
+			}
+		}
+	};
+
+	for(int i = 0; i < (int)SnesMemoryType::Register; i++) {
+		for(unique_ptr<CounterPage> &page : _pages[i]) {
+			if(page) {
+				for(uint32_t j = 0; j < PageSize; j++) {
+					rebase(page->Read[j]);
+					rebase(page->Write[j]);
+					rebase(page->Exec[j]);
+				}
+			}
+		}
+	}
+	_stampBase = stampBase;
 }
 
 uint64_t MemoryAccessCounter::GetReadCount(AddressInfo& addressInfo)
 {
-	return _counters[(int)addressInfo.Type][addressInfo.Address].ReadCount;
+	unique_ptr<CounterPage> &page = _pages[(int)addressInfo.Type][addressInfo.Address >> PageShift];
+	return page ? page->Read[addressInfo.Address & PageMask].Count : 0;
 }
 
 bool MemoryAccessCounter::ProcessMemoryRead(AddressInfo &addressInfo, uint64_t masterClock)
@@ -49,12 +87,14 @@ bool MemoryAccessCounter::ProcessMemoryRead(AddressInfo &addressInfo, uint64_t m
 		return false;
 	}
 
-	AddressCounters& counts = _counters[(int)addressInfo.Type][addressInfo.Address];
-	counts.ReadCount++;
-	counts.ReadStamp = masterClock;
-	if(counts.WriteCount == 0 && IsAddressUninitialized(addressInfo)) {
+	CounterPage* page = GetPage(addressInfo);
+	uint32_t offset = addressInfo.Address & PageMask;
+	AccessCount& counts = page->Read[offset];
+	counts.Count++;
+	counts.Stamp = GetStamp(masterClock);
+	if(page->Write[offset].Count == 0 && !DebugUtilities::IsRomMemory(addressInfo.Type)) {
 		//Mark address as read before being written to (if trying to read/execute)
-		counts.UninitRead = true;
+		page->UninitRead[offset >> 6] |= 1ULL << (offset & 0x3F);
 		return true;
 	}
 	return false;
@@ -66,9 +106,9 @@ void MemoryAccessCounter::ProcessMemoryWrite(AddressInfo& addressInfo, uint64_t
 		return;
 	}
 
-	AddressCounters& counts = _counters[(int)addressInfo.Type][addressInfo.Address];
-	counts.WriteCount++;
-	counts.WriteStamp = masterClock;
+	AccessCount& counts = GetPage(addressInfo)->Write[addressInfo.Address & PageMask];
+	counts.Count++;
+	counts.Stamp = GetStamp(masterClock);
 }
 
 void MemoryAccessCounter::ProcessMemoryExec(AddressInfo& addressInfo, uint64_t masterClock)
@@ -77,19 +117,41 @@ void MemoryAccessCounter::ProcessMemoryExec(AddressInfo& addressInfo, uint64_t m
 		return;
 	}
 
-	AddressCounters& counts = _counters[(int)addressInfo.Type][addressInfo.Address];
-	counts.ExecCount++;
-	counts.ExecStamp = masterClock;
+	AccessCount& counts = GetPage(addressInfo)->Exec[addressInfo.Address & PageMask];
+	counts.Count++;
+	counts.Stamp = GetStamp(masterClock);
 }
 
 void MemoryAccessCounter::ResetCounts()
 {
 	DebugBreakHelper helper(_debugger);
 	for(int i = 0; i < (int)SnesMemoryType::Register; i++) {
-		for(uint32_t j = 0; j < _counters[i].size(); j++) {
-			_counters[i][j] = { j };
+		for(unique_ptr<CounterPage> &page : _pages[i]) {
+			page.reset();
 		}
 	}
+	_stampBase = 0;
+}
+
+void MemoryAccessCounter::GetCounters(SnesMemoryType memType, uint32_t address, AddressCounters &counters)
+{
+	counters = {};
+	counters.Address = address;
+
+	vector<unique_ptr<CounterPage>> &pages = _pages[(int)memType];
+	CounterPage* page = (address >> PageShift) < pages.size() ? pages[address >> PageShift].get() : nullptr;
+	if(page) {
+		uint32_t offset = address & PageMask;
+		auto getStamp = [=](AccessCount &count) { return count.Stamp ? _stampBase + count.Stamp : 0; };
+
+		counters.ReadCount = page->Read[offset].Count;
+		counters.ReadStamp = getStamp(page->Read[offset]);
+		counters.UninitRead = (page->UninitRead[offset >> 6] & (1ULL << (offset & 0x3F))) != 0;
+		counters.WriteCount = page->Write[offset].Count;
+		counters.WriteStamp = getStamp(page->Write[offset]);
+		counters.ExecCount = page->Exec[offset].Count;
+		counters.ExecStamp = getStamp(page->Exec[offset]);
+	}
 }
 
 void MemoryAccessCounter::GetAccessCounts(uint32_t offset, uint32_t length, SnesMemoryType memoryType, AddressCounters counts[])
@@ -99,7 +161,7 @@ void MemoryAccessCounter::GetAccessCounts(uint32_t offset, uint32_t length, Snes
 			for(uint32_t i = 0; i < length; i++) {
 				AddressInfo info = _memoryManager->GetMemoryMappings()->GetAbsoluteAddress(offset + i);
 				if(info.Address >= 0) {
-					counts[i] = _counters[(int)info.Type][info.Address];
+					GetCounters(info.Type, info.Address, counts[i]);
 				}
 			}
 			break;
@@ -108,7 +170,7 @@ void MemoryAccessCounter::GetAccessCounts(uint32_t offset, uint32_t length, Snes
 			for(uint32_t i = 0; i < length; i++) {
 				AddressInfo info = _spc->GetAbsoluteAddress(offset + i);
 				if(info.Address >= 0) {
-					counts[i] = _counters[(int)info.Type][info.Address];
+					GetCounters(info.Type, info.Address, counts[i]);
 				}
 			}
 			break;
@@ -118,7 +180,7 @@ void MemoryAccessCounter::GetAccessCounts(uint32_t offset, uint32_t length, Snes
 				for(uint32_t i = 0; i < length; i++) {
 					AddressInfo info = _sa1->GetMemoryMappings()->GetAbsoluteAddress(offset + i);
 					if(info.Address >= 0) {
-						counts[i] = _counters[(int)info.Type][info.Address];
+						GetCounters(info.Type, info.Address, counts[i]);
 					}
 				}
 			}
@@ -129,7 +191,7 @@ void MemoryAccessCounter::GetAccessCounts(uint32_t offset, uint32_t length, Snes
 				for(uint32_t i = 0; i < length; i++) {
 					AddressInfo info = _gsu->GetMemoryMappings()->GetAbsoluteAddress(offset + i);
 					if(info.Address >= 0) {
-						counts[i] = _counters[(int)info.Type][info.Address];
+						GetCounters(info.Type, info.Address, counts[i]);
 					}
 				}
 			}
@@ -140,7 +202,7 @@ void MemoryAccessCounter::GetAccessCounts(uint32_t offset, uint32_t length, Snes
 				for(uint32_t i = 0; i < length; i++) {
 					AddressInfo info = _cx4->GetMemoryMappings()->GetAbsoluteAddress(offset + i);
 					if(info.Address >= 0) {
-						counts[i] = _counters[(int)info.Type][info.Address];
+						GetCounters(info.Type, info.Address, counts[i]);
 					}
 				}
 			}
@@ -151,14 +213,16 @@ void MemoryAccessCounter::GetAccessCounts(uint32_t offset, uint32_t length, Snes
 				for(uint32_t i = 0; i < length; i++) {
 					AddressInfo info = _gameboy->GetAbsoluteAddress(offset + i);
 					if(info.Address >= 0) {
-						counts[i] = _counters[(int)info.Type][info.Address];
+						GetCounters(info.Type, info.Address, counts[i]);
 					}
 				}
 			}
 			break;
 
 		default:
-			memcpy(counts, _counters[(int)memoryType].data() + offset, length * sizeof(AddressCounters));
+			for(uint32_t i = 0; i < length; i++) {
+				GetCounters(memoryType, offset + i, counts[i]);
+			}
 			break;
 	}
 }
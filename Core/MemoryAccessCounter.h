@@ -28,7 +28,27 @@ struct AddressCounters
 class MemoryAccessCounter
 {
 private:
-	vector<AddressCounters> _counters[(int)SnesMemoryType::Register];
+	static constexpr uint32_t PageShift = 10;
+	static constexpr uint32_t PageSize = 1 << PageShift;
+	static constexpr uint32_t PageMask = PageSize - 1;
+
+	struct AccessCount
+	{
+		uint32_t Count;
+		uint32_t Stamp; //Master clock of the last access, relative to _stampBase (0 = never accessed)
+	};
+
+	//Counters for a 1 KB block of memory, only allocated once one of its addresses is accessed
+	struct CounterPage
+	{
+		AccessCount Read[PageSize];
+		AccessCount Write[PageSize];
+		AccessCount Exec[PageSize];
+		uint64_t UninitRead[PageSize / 64];
+	};
+
+	vector<unique_ptr<CounterPage>> _pages[(int)SnesMemoryType::Register];
+	uint64_t _stampBase = 0;
 
 	Debugger* _debugger;
 	MemoryManager* _memoryManager;
@@ -38,7 +58,10 @@ private:
 	Cx4* _cx4;
 	Gameboy* _gameboy;
 
-	bool IsAddressUninitialized(AddressInfo &addressInfo);
+	__forceinline CounterPage* GetPage(AddressInfo &addressInfo);
+	__forceinline uint32_t GetStamp(uint64_t masterClock);
+	void SetStampBase(uint64_t stampBase);
+	void GetCounters(SnesMemoryType memType, uint32_t address, AddressCounters &counters);
 
 public:
 	MemoryAccessCounter(Debugger *debugger, Console *console);
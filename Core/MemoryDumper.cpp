@@ -200,8 +200,12 @@ void MemoryDumper::SetMemoryValue(SnesMemoryType memoryType, uint32_t address, u
 	auto invalidateCache = [=]() {
 		AddressInfo addr = { (int32_t)address, memoryType };
 		_debugger->GetDisassembler()->InvalidateCache(addr, DebugUtilities::ToCpuType(memoryType));
+		_debugger->GetDisassembler()->MarkDirty(addr);
 	};
 
+	//Writes can have side effects on the registers (e.g when writing to PPU registers)
+	_debugger->InvalidateStateSnapshot();
+
 	switch(memoryType) {
 		case SnesMemoryType::CpuMemory: _memoryManager->GetMemoryMappings()->DebugWrite(address, value); break;
 		case SnesMemoryType::SpcMemory: _spc->DebugWrite(address, value); break;
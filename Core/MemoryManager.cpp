@@ -128,52 +128,71 @@ void MemoryManager::GenerateMasterClockTable()
 
 void MemoryManager::IncMasterClock4()
 {
-	Exec();
-	Exec();
+	RunClocks(4);
 }
 
 void MemoryManager::IncMasterClock6()
 {
-	Exec();
-	Exec();
-	Exec();
+	RunClocks(6);
 }
 
 void MemoryManager::IncMasterClock8()
 {
-	Exec();
-	Exec();
-	Exec();
-	Exec();
+	RunClocks(8);
 }
 
 void MemoryManager::IncMasterClock40()
 {
-	Exec(); Exec(); Exec(); Exec(); Exec();
-	Exec(); Exec(); Exec(); Exec(); Exec();
-	Exec(); Exec(); Exec(); Exec(); Exec();
-	Exec(); Exec(); Exec(); Exec(); Exec();
+	RunClocks(40);
 }
 
 void MemoryManager::IncMasterClockStartup()
 {
-	for(int i = 0; i < 182 / 2; i++) {
-		Exec();
-	}
+	RunClocks(182);
 }
 
 void MemoryManager::IncrementMasterClockValue(uint16_t cyclesToRun)
 {
-	switch(cyclesToRun) {
-		case 12: Exec();
-		case 10: Exec();
-		case 8: Exec();
-		case 6: Exec();
-		case 4: Exec();
-		case 2: Exec();
+	RunClocks(cyclesToRun);
+}
+
+__forceinline void MemoryManager::RunClocks(uint16_t clocks)
+{
+	if(!RunClocksInBulk(clocks)) {
+		for(uint16_t i = 0; i < clocks; i += 2) {
+			Exec();
+		}
 	}
 }
 
+__forceinline bool MemoryManager::RunClocksInBulk(uint16_t clocks)
+{
+	if(_console->IsDebugging()) {
+		//The debugger needs to be called on every PPU cycle
+		return false;
+	}
+
+	if((uint16_t)(_nextEventClock - _hClock) <= clocks) {
+		//An event (HDMA, DRAM refresh, end of scanline) occurs during this period
+		return false;
+	}
+
+	//Range of H clock values where Exec() would process the IRQ counters (every 4 master clocks)
+	uint16_t firstIrqClock = (_hClock + 4) & ~0x03;
+	uint16_t lastIrqClock = (_hClock + clocks) & ~0x03;
+	if(firstIrqClock <= lastIrqClock && !_regs->ProcessIrqCounters(firstIrqClock, lastIrqClock)) {
+		//IRQ state could change during this period
+		return false;
+	}
+
+	_masterClock += clocks;
+	_hClock += clocks;
+
+	//Coprocessors catch up to the master clock, so a single sync at the end of the period is enough
+	_cart->SyncCoprocessors();
+	return true;
+}
+
 void MemoryManager::Exec()
 {
 	_masterClock += 2;
@@ -244,7 +263,13 @@ uint8_t MemoryManager::Read(uint32_t addr, MemoryOperationType type)
 
 	uint8_t value;
 	IMemoryHandler *handler = _mappings.GetHandler(addr);
-	if(handler) {
+	uint8_t* directPointer = _mappings.GetDirectReadPointer(addr);
+	if(directPointer) {
+		//Plain ROM/RAM, read directly without going through the handler
+		value = directPointer[addr & 0xFFF];
+		_memTypeBusA = handler->GetMemoryType();
+		_openBus = value;
+	} else if(handler) {
 		value = handler->Read(addr);
 		_memTypeBusA = handler->GetMemoryType();
 		_openBus = value;
@@ -57,6 +57,8 @@ private:
 	uint8_t _masterClockTable[0x800];
 
 	void Exec();
+	void RunClocks(uint16_t clocks);
+	bool RunClocksInBulk(uint16_t clocks);
 
 	void ProcessEvent();
 
@@ -1,20 +1,44 @@
 #pragma once
 #include "stdafx.h"
 #include "DebugTypes.h"
-
-class IMemoryHandler;
+#include "IMemoryHandler.h"
 
 class MemoryMappings
 {
 private:
 	IMemoryHandler* _handlers[0x100 * 0x10] = {};
+	uint8_t* _directReadPointers[0x100 * 0x10] = {};
+
+	//Absolute address of the start of each page that has a direct read pointer (plain ROM/RAM, whose translation can't change)
+	AddressInfo _absolutePages[0x100 * 0x10] = {};
+
+	void SetHandler(uint16_t page, IMemoryHandler* handler);
+	AddressInfo GetHandlerAbsoluteAddress(uint32_t addr);
 
 public:
 	void RegisterHandler(uint8_t startBank, uint8_t endBank, uint16_t startPage, uint16_t endPage, vector<unique_ptr<IMemoryHandler>>& handlers, uint16_t pageIncrement = 0, uint16_t startPageNumber = 0);
 	void RegisterHandler(uint8_t startBank, uint8_t endBank, uint16_t startAddr, uint16_t endAddr, IMemoryHandler* handler);
 
-	IMemoryHandler* GetHandler(uint32_t addr);
-	AddressInfo GetAbsoluteAddress(uint32_t addr);
+	__forceinline IMemoryHandler* GetHandler(uint32_t addr)
+	{
+		return _handlers[addr >> 12];
+	}
+
+	//Returns the start of the 4KB page for pages mapped to plain ROM/RAM (or nullptr for registers, coprocessors, etc.)
+	__forceinline uint8_t* GetDirectReadPointer(uint32_t addr)
+	{
+		return _directReadPointers[addr >> 12];
+	}
+
+	__forceinline AddressInfo GetAbsoluteAddress(uint32_t addr)
+	{
+		uint32_t page = addr >> 12;
+		if(_directReadPointers[page]) {
+			return { _absolutePages[page].Address + (int32_t)(addr & 0xFFF), _absolutePages[page].Type };
+		}
+		return GetHandlerAbsoluteAddress(addr);
+	}
+
 	int GetRelativeAddress(AddressInfo& absAddress, uint8_t startBank = 0);
 
 	uint8_t Peek(uint32_t addr);
@@ -1,7 +1,7 @@
 #pragma once
 #include "stdafx.h"
 #include "../Utilities/stb_vorbis.h"
-#include "../Utilities/HermiteResampler.h"
+#include "../Utilities/PolyphaseResampler.h"
 
 class PcmReader
 {
@@ -22,7 +22,7 @@ private:
 	bool _loop;
 	bool _done;
 
-	HermiteResampler _resampler;
+	PolyphaseResampler _resampler;
 	vector<int16_t> _pcmBuffer;
 	uint32_t _leftoverSampleCount = 0;
 
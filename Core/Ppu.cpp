@@ -14,6 +14,7 @@
 #include "MessageManager.h"
 #include "EventType.h"
 #include "RewindManager.h"
+#include "BenchmarkCounters.h"
 #include "../Utilities/HexUtilities.h"
 #include "../Utilities/Serializer.h"
 
@@ -91,9 +92,13 @@ uint16_t Ppu::GetScanline()
 }
 
 uint16_t Ppu::GetCycle()
+{
+	return GetCycle(_memoryManager->GetHClock());
+}
+
+uint16_t Ppu::GetCycle(uint16_t hClock)
 {
 	//"normally dots 323 and 327 are 6 master cycles instead of 4."
-	uint16_t hClock = _memoryManager->GetHClock();
 	if(hClock <= 1292) {
 		return hClock >> 2;
 	} else if(hClock <= 1310) {
@@ -826,6 +831,8 @@ void Ppu::RenderMode7()
 
 void Ppu::RenderScanline()
 {
+	BENCHMARK_SECTION(BenchmarkSection::Ppu);
+
 	int32_t hPos = GetCycle();
 
 	if(hPos <= 255 || _spriteEvalEnd < 255) {
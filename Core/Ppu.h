@@ -216,6 +216,7 @@ public:
 	uint16_t GetVblankEndScanline();
 	uint16_t GetScanline();
 	uint16_t GetCycle();
+	static uint16_t GetCycle(uint16_t hClock);
 	uint16_t GetNmiScanline();
 	uint16_t GetVblankStart();
 
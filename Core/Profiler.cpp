@@ -6,12 +6,15 @@
 #include "Console.h"
 #include "MemoryDumper.h"
 #include "DebugTypes.h"
+#include "LabelManager.h"
+#include "../Utilities/HexUtilities.h"
 
 static constexpr int32_t ResetFunctionIndex = -1;
 
-Profiler::Profiler(Debugger* debugger)
+Profiler::Profiler(Debugger* debugger, CpuType cpuType)
 {
 	_debugger = debugger;
+	_cpuType = cpuType;
 	_console = debugger->GetConsole().get();
 	InternalReset();
 }
@@ -22,25 +25,31 @@ Profiler::~Profiler()
 
 void Profiler::StackFunction(AddressInfo &addr, StackFrameFlags stackFlag)
 {
-	if(addr.Address >= 0) {
-		uint32_t key = addr.Address | ((uint8_t)addr.Type << 24);
-		if(_functions.find(key) == _functions.end()) {
-			_functions[key] = ProfiledFunction();
-			_functions[key].Address = addr;
-		}
+	//Calls to unmapped addresses are stacked as an unknown function, to keep every CallstackManager frame paired with a profiler frame
+	int32_t key = addr.Address >= 0 ? (addr.Address | ((uint8_t)addr.Type << 24)) : ResetFunctionIndex;
 
-		UpdateCycles();
+	if(_mode == ProfilerMode::Sampling) {
+		_sampleStack.push_back(key);
+		return;
+	}
 
-		_stackFlags.push_back(stackFlag);
-		_cycleCountStack.push_back(_currentCycleCount);
-		_functionStack.push_back(_currentFunction);
+	if(key != ResetFunctionIndex && _functions.find(key) == _functions.end()) {
+		_functions[key] = ProfiledFunction();
+		_functions[key].Address = addr;
+	}
+
+	UpdateCycles();
 
-		ProfiledFunction& func = _functions[key];
-		func.CallCount++;
+	_stackFlags.push_back(stackFlag);
+	_cycleCountStack.push_back(_currentCycleCount);
+	_functionStack.push_back(_currentFunction);
 
-		_currentFunction = key;
-		_currentCycleCount = 0;
+	if(key != ResetFunctionIndex) {
+		_functions[key].CallCount++;
 	}
+
+	_currentFunction = key;
+	_currentCycleCount = 0;
 }
 
 void Profiler::UpdateCycles()
@@ -67,6 +76,16 @@ void Profiler::UpdateCycles()
 
 void Profiler::UnstackFunction()
 {
+	if(_mode == ProfilerMode::Sampling) {
+		if(!_sampleStack.empty()) {
+			_sampleStack.pop_back();
+			if(_sampleStackNodes.size() > _sampleStack.size()) {
+				_sampleStackNodes.pop_back();
+			}
+		}
+		return;
+	}
+
 	if(!_functionStack.empty()) {
 		UpdateCycles();
 
@@ -85,6 +104,24 @@ void Profiler::UnstackFunction()
 	}
 }
 
+void Profiler::DropOldestFrame()
+{
+	if(_mode == ProfilerMode::Sampling) {
+		if(!_sampleStack.empty()) {
+			_sampleStack.erase(_sampleStack.begin());
+			//Every frame now has a different parent, the call tree nodes are looked up again on the next sample
+			_sampleStackNodes.clear();
+		}
+		return;
+	}
+
+	if(!_functionStack.empty()) {
+		_functionStack.pop_front();
+		_stackFlags.pop_front();
+		_cycleCountStack.pop_front();
+	}
+}
+
 void Profiler::Reset()
 {
 	DebugBreakHelper helper(_debugger);
@@ -103,11 +140,210 @@ void Profiler::InternalReset()
 	_functions.clear();
 	_functions[ResetFunctionIndex] = ProfiledFunction();
 	_functions[ResetFunctionIndex].Address = { ResetFunctionIndex, SnesMemoryType::Register };
+
+	_sampleStack.clear();
+	_sampleStackNodes.clear();
+	_sampleNodeLookup.clear();
+	_sampleNodes.clear();
+	_sampleNodes.push_back({ ResetFunctionIndex, 0 });
+	_droppedSampleCount = 0;
+	//Set by the first instruction processed, based on the profiled CPU's own clock
+	_nextSampleClock = 0;
+	if(_mode == ProfilerMode::Sampling) {
+		_samples = vector<ProfilerSample>(SampleTableSize);
+	} else {
+		vector<ProfilerSample>().swap(_samples);
+	}
+}
+
+void Profiler::SetMode(ProfilerMode mode, uint32_t samplePeriod)
+{
+	DebugBreakHelper helper(_debugger);
+	_mode = mode;
+	_samplePeriod = std::max<uint32_t>(samplePeriod, 1);
+	InternalReset();
+}
+
+void Profiler::CopyMode(Profiler* profiler)
+{
+	//Used to keep the mode when the profiler is recreated on reset
+	_mode = profiler->_mode;
+	_samplePeriod = profiler->_samplePeriod;
+	InternalReset();
+}
+
+void Profiler::ProcessInstruction(AddressInfo &addr, uint64_t clock)
+{
+	if(_nextSampleClock == 0) {
+		_nextSampleClock = clock + _samplePeriod;
+	} else if(clock >= _nextSampleClock) {
+		AddSample(addr, clock);
+	}
+}
+
+uint32_t Profiler::GetSampleNode(uint32_t parent, int32_t function)
+{
+	uint64_t key = ((uint64_t)parent << 32) | (uint32_t)function;
+	auto result = _sampleNodeLookup.find(key);
+	if(result != _sampleNodeLookup.end()) {
+		return result->second;
+	}
+
+	if(_sampleNodes.size() >= MaxSampleNodes) {
+		//Call tree is full, count the samples in the caller instead
+		return parent;
+	}
+
+	uint32_t node = (uint32_t)_sampleNodes.size();
+	_sampleNodes.push_back({ function, parent });
+	_sampleNodeLookup[key] = node;
+	return node;
+}
+
+void Profiler::AddSample(AddressInfo &addr, uint64_t clock)
+{
+	//Weigh the sample by the number of periods that elapsed (long DMA transfers, etc.)
+	uint64_t periods = (clock - _nextSampleClock) / _samplePeriod + 1;
+	_nextSampleClock += periods * _samplePeriod;
+	uint32_t count = (uint32_t)std::min<uint64_t>(periods, UINT32_MAX);
+
+	//Only the frames pushed since the last sample need to be looked up in the call tree
+	uint32_t node = _sampleStackNodes.empty() ? 0 : _sampleStackNodes.back();
+	for(size_t i = _sampleStackNodes.size(); i < _sampleStack.size(); i++) {
+		node = GetSampleNode(node, _sampleStack[i]);
+		_sampleStackNodes.push_back(node);
+	}
+
+	int32_t pc = addr.Address >= 0 ? (addr.Address | ((uint8_t)addr.Type << 24)) : ResetFunctionIndex;
+	uint32_t hash = (node * 0x9E3779B1) ^ ((uint32_t)pc * 0x85EBCA6B);
+	hash ^= hash >> 16;
+	for(uint32_t i = 0; i < 16; i++) {
+		ProfilerSample &sample = _samples[(hash + i) & (SampleTableSize - 1)];
+		if(sample.Count == 0) {
+			sample = { node, pc, count };
+			return;
+		} else if(sample.Node == node && sample.Address == pc) {
+			sample.Count += count;
+			return;
+		}
+	}
+
+	//Table is full around this slot
+	_droppedSampleCount += count;
+}
+
+string Profiler::GetFunctionName(int32_t key)
+{
+	if(key == ResetFunctionIndex) {
+		return "[unknown]";
+	}
+
+	AddressInfo absAddr = { key & 0xFFFFFF, (SnesMemoryType)((uint32_t)key >> 24) };
+	string label = _debugger->GetLabelManager()->GetLabel(absAddr);
+	if(!label.empty()) {
+		return label;
+	}
+
+	AddressInfo relAddr = _debugger->GetRelativeAddress(absAddr, _cpuType);
+	return "$" + HexUtilities::ToHex24(relAddr.Address >= 0 ? relAddr.Address : absAddr.Address);
+}
+
+const char* Profiler::GetFoldedStacks()
+{
+	DebugBreakHelper helper(_debugger);
+
+	_foldedStacks.clear();
+	if(_mode != ProfilerMode::Sampling) {
+		return _foldedStacks.c_str();
+	}
+
+	//Nodes are always created after their parent, so the paths can be built in a single pass
+	unordered_map<int32_t, string> names;
+	auto getName = [&](int32_t key) -> string& {
+		auto result = names.find(key);
+		if(result == names.end()) {
+			result = names.emplace(key, GetFunctionName(key)).first;
+		}
+		return result->second;
+	};
+
+	vector<string> paths(_sampleNodes.size());
+	for(size_t i = 1; i < _sampleNodes.size(); i++) {
+		string &parentPath = paths[_sampleNodes[i].Parent];
+		paths[i] = parentPath.empty() ? getName(_sampleNodes[i].Function) : (parentPath + ";" + getName(_sampleNodes[i].Function));
+	}
+
+	for(ProfilerSample &sample : _samples) {
+		if(sample.Count > 0) {
+			string &path = paths[sample.Node];
+			if(!path.empty()) {
+				_foldedStacks += path;
+				_foldedStacks += ";";
+			}
+			_foldedStacks += getName(sample.Address) + " " + std::to_string(sample.Count) + "\n";
+		}
+	}
+
+	if(_droppedSampleCount > 0) {
+		_foldedStacks += "[dropped] " + std::to_string(_droppedSampleCount) + "\n";
+	}
+
+	return _foldedStacks.c_str();
+}
+
+void Profiler::GetSampledProfilerData(ProfiledFunction* profilerData, uint32_t& functionCount)
+{
+	unordered_map<int32_t, ProfiledFunction> functions;
+	vector<int32_t> pathFunctions;
+	for(ProfilerSample &sample : _samples) {
+		if(sample.Count == 0) {
+			continue;
+		}
+
+		uint64_t cycles = (uint64_t)sample.Count * _samplePeriod;
+		functions[_sampleNodes[sample.Node].Function].ExclusiveCycles += cycles;
+
+		//Count inclusive time once per function, even for recursive calls
+		pathFunctions.clear();
+		uint32_t node = sample.Node;
+		while(true) {
+			int32_t function = _sampleNodes[node].Function;
+			if(std::find(pathFunctions.begin(), pathFunctions.end(), function) == pathFunctions.end()) {
+				pathFunctions.push_back(function);
+				functions[function].InclusiveCycles += cycles;
+			}
+			if(node == 0) {
+				break;
+			}
+			node = _sampleNodes[node].Parent;
+		}
+	}
+
+	functionCount = 0;
+	for(auto &func : functions) {
+		if(func.first == ResetFunctionIndex) {
+			func.second.Address = { ResetFunctionIndex, SnesMemoryType::Register };
+		} else {
+			func.second.Address = { func.first & 0xFFFFFF, (SnesMemoryType)((uint32_t)func.first >> 24) };
+		}
+		func.second.MinCycles = 0;
+		profilerData[functionCount] = func.second;
+		functionCount++;
+
+		if(functionCount >= 100000) {
+			break;
+		}
+	}
 }
 
 void Profiler::GetProfilerData(ProfiledFunction* profilerData, uint32_t& functionCount)
 {
 	DebugBreakHelper helper(_debugger);
+
+	if(_mode == ProfilerMode::Sampling) {
+		GetSampledProfilerData(profilerData, functionCount);
+		return;
+	}
 	
 	UpdateCycles();
 
@@ -15,11 +15,33 @@ struct ProfiledFunction
 	AddressInfo Address;
 };
 
+enum class ProfilerMode
+{
+	//Tracks every call/return and counts the exact number of cycles spent in each function
+	Exact = 0,
+	//Records the current function stack and PC every N clocks of the profiled CPU (master clocks for the main CPU)
+	Sampling = 1
+};
+
+struct ProfilerSampleNode
+{
+	int32_t Function;
+	uint32_t Parent;
+};
+
+struct ProfilerSample
+{
+	uint32_t Node;
+	int32_t Address;
+	uint32_t Count;
+};
+
 class Profiler
 {
 private:
 	Debugger* _debugger;
 	Console* _console;
+	CpuType _cpuType;
 
 	unordered_map<int32_t, ProfiledFunction> _functions;
 	
@@ -31,16 +53,46 @@ private:
 	uint64_t _prevMasterClock;
 	int32_t _currentFunction;
 
+	//Sampling mode - samples are counted in a fixed-size hash table, keyed by call tree node and PC
+	static constexpr uint32_t SampleTableSize = 0x10000;
+	static constexpr uint32_t MaxSampleNodes = 0x40000;
+
+	ProfilerMode _mode = ProfilerMode::Exact;
+	uint32_t _samplePeriod = 0;
+	uint64_t _nextSampleClock = 0;
+	vector<int32_t> _sampleStack;
+	vector<uint32_t> _sampleStackNodes;
+	vector<ProfilerSampleNode> _sampleNodes;
+	unordered_map<uint64_t, uint32_t> _sampleNodeLookup;
+	vector<ProfilerSample> _samples;
+	uint64_t _droppedSampleCount = 0;
+	string _foldedStacks;
+
 	void InternalReset();
 	void UpdateCycles();
 
+	uint32_t GetSampleNode(uint32_t parent, int32_t function);
+	void AddSample(AddressInfo &addr, uint64_t clock);
+	void GetSampledProfilerData(ProfiledFunction* profilerData, uint32_t& functionCount);
+	string GetFunctionName(int32_t key);
+
 public:
-	Profiler(Debugger* debugger);
+	Profiler(Debugger* debugger, CpuType cpuType);
 	~Profiler();
 
 	void StackFunction(AddressInfo& addr, StackFrameFlags stackFlag);
 	void UnstackFunction();
+	void DropOldestFrame();
 
 	void Reset();
 	void GetProfilerData(ProfiledFunction* profilerData, uint32_t& functionCount);
+
+	void SetMode(ProfilerMode mode, uint32_t samplePeriod);
+	void CopyMode(Profiler* profiler);
+	bool IsSampling() { return _mode == ProfilerMode::Sampling; }
+	//Coprocessors run in batches while the master clock stands still, so each CPU passes its own cycle counter
+	void ProcessInstruction(AddressInfo &addr, uint64_t clock);
+
+	//Returns the samples in the "folded stacks" format used by flamegraph tools (one "caller;callee;pc count" line per stack)
+	const char* GetFoldedStacks();
 };
\ No newline at end of file
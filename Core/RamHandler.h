@@ -52,6 +52,12 @@ public:
 		_ram[addr & _mask] = value;
 	}
 
+	uint8_t* GetDirectReadPointer() override
+	{
+		//Pages smaller than 4KB are mirrored and need to go through Read()
+		return _mask == 0xFFF ? _ram : nullptr;
+	}
+
 	AddressInfo GetAbsoluteAddress(uint32_t address) override
 	{
 		AddressInfo info;
@@ -2,30 +2,340 @@
 #include "RewindData.h"
 #include "Console.h"
 #include "SaveStateManager.h"
+#include "../Utilities/Serializer.h"
 #include "../Utilities/miniz.h"
 
+shared_ptr<RewindData::BufferPool> RewindData::_bufferPool(new RewindData::BufferPool());
+
+RewindData::BufferPool::~BufferPool()
+{
+	for(vector<uint8_t>* buffer : Buffers) {
+		delete buffer;
+	}
+}
+
+shared_ptr<vector<uint8_t>> RewindData::GetBuffer(uint32_t size)
+{
+	shared_ptr<BufferPool> pool = _bufferPool;
+	vector<uint8_t>* buffer = nullptr;
+	{
+		auto lock = pool->Lock.AcquireSafe();
+
+		//Use the smallest buffer that fits, unless it would waste more than half of its capacity
+		int best = -1;
+		for(int i = 0; i < (int)pool->Buffers.size(); i++) {
+			size_t capacity = pool->Buffers[i]->capacity();
+			if(capacity >= size && capacity <= (size_t)size * 2 && (best < 0 || capacity < pool->Buffers[best]->capacity())) {
+				best = i;
+			}
+		}
+
+		if(best >= 0) {
+			buffer = pool->Buffers[best];
+			pool->Buffers[best] = pool->Buffers.back();
+			pool->Buffers.pop_back();
+		}
+	}
+
+	if(!buffer) {
+		buffer = new vector<uint8_t>();
+		buffer->reserve(size);
+	}
+	buffer->resize(size);
+
+	return shared_ptr<vector<uint8_t>>(buffer, [pool](vector<uint8_t>* released) {
+		auto lock = pool->Lock.AcquireSafe();
+		if(pool->Buffers.size() < RewindData::MaxPoolSize) {
+			pool->Buffers.push_back(released);
+		} else {
+			delete released;
+		}
+	});
+}
+
+shared_ptr<vector<uint8_t>> RewindData::Compress(uint8_t* data, uint32_t size)
+{
+	//Same format as Serializer::Save: [decompressed size][compressed size][zlib data]
+	unsigned long compressedSize = compressBound(size);
+	shared_ptr<vector<uint8_t>> buffer = GetBuffer(compressedSize + 8);
+	compress2(buffer->data() + 8, &compressedSize, data, size, MZ_BEST_SPEED);
+
+	//Copy the result to a buffer of the right size, the compressed data is usually much smaller than the bound
+	uint32_t header[2] = { size, (uint32_t)compressedSize };
+	memcpy(buffer->data(), header, sizeof(header));
+	shared_ptr<vector<uint8_t>> output = GetBuffer((uint32_t)compressedSize + 8);
+	memcpy(output->data(), buffer->data(), compressedSize + 8);
+	return output;
+}
+
+uint32_t RewindData::GetDecompressedSize(vector<uint8_t> &compressedData)
+{
+	uint32_t size;
+	memcpy(&size, compressedData.data(), sizeof(uint32_t));
+	return size;
+}
+
+void RewindData::Decompress(vector<uint8_t> &compressedData, vector<uint8_t> &output)
+{
+	uint32_t header[2];
+	memcpy(header, compressedData.data(), sizeof(header));
+
+	output.resize(header[0]);
+	unsigned long size = header[0];
+	uncompress(output.data(), &size, compressedData.data() + 8, header[1]);
+}
+
+uint32_t RewindData::EncodeDelta(uint8_t* state, uint8_t* previousState, uint32_t size, uint8_t* output)
+{
+	//When output is null, only the size required to encode the delta is calculated
+	uint32_t outputSize = 0;
+	uint32_t pos = 0;
+	while(pos < size) {
+		//Skip over identical bytes (8 bytes at a time when possible)
+		uint32_t start = pos;
+		while(pos + 8 <= size && memcmp(state + pos, previousState + pos, 8) == 0) {
+			pos += 8;
+		}
+		while(pos < size && state[pos] == previousState[pos]) {
+			pos++;
+		}
+
+		if(pos == size) {
+			break;
+		}
+
+		//Find the end of the modified range, small gaps of identical bytes are merged into it
+		uint32_t runStart = pos;
+		uint32_t runEnd = pos;
+		while(pos < size && pos - runEnd < RewindData::MaxGapSize) {
+			if(state[pos] != previousState[pos]) {
+				runEnd = pos + 1;
+			}
+			pos++;
+		}
+
+		uint32_t skip = runStart - start;
+		uint32_t length = runEnd - runStart;
+		if(output) {
+			memcpy(output + outputSize, &skip, sizeof(uint32_t));
+			memcpy(output + outputSize + 4, &length, sizeof(uint32_t));
+			uint8_t* xorData = output + outputSize + 8;
+			for(uint32_t i = 0; i < length; i++) {
+				xorData[i] = state[runStart + i] ^ previousState[runStart + i];
+			}
+		}
+		outputSize += 8 + length;
+		pos = runEnd;
+	}
+	return outputSize;
+}
+
+void RewindData::ApplyDelta(vector<uint8_t> &delta, vector<uint8_t> &stateData)
+{
+	uint8_t* data = stateData.data();
+	uint8_t* deltaData = delta.data();
+	uint32_t pos = 0;
+	size_t i = 0;
+	while(i < delta.size()) {
+		uint32_t skip, length;
+		memcpy(&skip, deltaData + i, sizeof(uint32_t));
+		memcpy(&length, deltaData + i + 4, sizeof(uint32_t));
+		i += 8;
+		pos += skip;
+
+		uint8_t* xorData = deltaData + i;
+		for(uint32_t j = 0; j < length; j++) {
+			data[pos + j] ^= xorData[j];
+		}
+		pos += length;
+		i += length;
+	}
+}
+
+void RewindData::DecodeState(vector<uint8_t> &stateData)
+{
+	shared_ptr<vector<uint8_t>> keyFrameData;
+	shared_ptr<vector<uint8_t>> keyFrameState;
+	{
+		auto lock = _keyFrame->Lock.AcquireSafe();
+		keyFrameData = _keyFrame->Data;
+		keyFrameState = _keyFrame->State;
+	}
+
+	if(keyFrameData) {
+		Decompress(*keyFrameData, stateData);
+	} else {
+		stateData.assign(keyFrameState->begin(), keyFrameState->end());
+	}
+
+	if(!_delta) {
+		return;
+	}
+
+	//Apply the chain's deltas in order, starting from the one encoded against the key frame
+	vector<DeltaBlock*> chain;
+	uint32_t maxDeltaSize = 0;
+	for(DeltaBlock* delta = _delta.get(); delta; delta = delta->Previous.get()) {
+		chain.push_back(delta);
+		maxDeltaSize = std::max(maxDeltaSize, GetDecompressedSize(*delta->Data));
+	}
+
+	shared_ptr<vector<uint8_t>> delta = GetBuffer(maxDeltaSize);
+	for(auto it = chain.rbegin(); it != chain.rend(); it++) {
+		Decompress(*(*it)->Data, *delta);
+		ApplyDelta(*delta, stateData);
+	}
+}
+
+uint32_t RewindData::GetKeyFrameSize(KeyFrame &keyFrame)
+{
+	//Key frames are usually compressed long before the next block is saved, use the uncompressed size otherwise
+	auto lock = keyFrame.Lock.AcquireSafe();
+	return (uint32_t)(keyFrame.Data ? keyFrame.Data->size() : keyFrame.State->size());
+}
+
+RewindData::RewindData(const RewindData &other)
+{
+	*this = other;
+}
+
+RewindData& RewindData::operator=(const RewindData &other)
+{
+	for(int i = 0; i < BaseControlDevice::PortCount; i++) {
+		InputLogs[i] = other.InputLogs[i];
+	}
+	FrameCount = other.FrameCount;
+	EndOfSegment = other.EndOfSegment;
+
+	_keyFrame = other._keyFrame;
+	_delta = other._delta;
+	_stateData = other._stateData;
+
+	//Only the current block keeps its uncompressed state
+	_state.reset();
+	return *this;
+}
+
 void RewindData::GetStateData(stringstream &stateData)
 {
-	stateData.write((char*)SaveStateData.data(), SaveStateData.size());
+	if(!_keyFrame) {
+		return;
+	}
+
+	//Key frames are already stored in the same format as Serializer::Save, delta blocks are rebuilt and compressed once
+	vector<uint8_t>* data;
+	if(_delta) {
+		if(!_stateData) {
+			vector<uint8_t> state;
+			DecodeState(state);
+			_stateData = Compress(state.data(), (uint32_t)state.size());
+		}
+		data = _stateData.get();
+	} else {
+		CompressKeyFrame(*_keyFrame);
+		data = _keyFrame->Data.get();
+	}
+	stateData.write((char*)data->data(), data->size());
 }
 
 void RewindData::LoadState(shared_ptr<Console> &console)
 {
-	if(SaveStateData.size() > 0) {
-		stringstream stream;
-		stream.write((char*)SaveStateData.data(), SaveStateData.size());
-		stream.seekg(0, ios::beg);
+	if(_keyFrame) {
+		vector<uint8_t> data;
+		DecodeState(data);
 
-		console->Deserialize(stream, SaveStateManager::FileFormatVersion);
+		Serializer serializer(std::move(data), SaveStateManager::FileFormatVersion);
+		console->Deserialize(serializer);
 	}
 }
 
-void RewindData::SaveState(shared_ptr<Console> &console)
+void RewindData::SaveState(shared_ptr<Console> &console, RewindData* previousData)
 {
-	std::stringstream state;
-	console->Serialize(state);
+	Serializer serializer(SaveStateManager::FileFormatVersion);
+	console->Serialize(serializer);
 
-	string data = state.str();
-	SaveStateData = vector<uint8_t>(data.c_str(), data.c_str()+data.size());
+	uint8_t* state = serializer.GetData();
+	uint32_t size = serializer.GetSize();
 	FrameCount = 0;
+	_delta.reset();
+
+	//The previous block is no longer the current block, it doesn't need to keep its uncompressed state
+	shared_ptr<vector<uint8_t>> previousState;
+	if(previousData) {
+		previousState = std::move(previousData->_state);
+	}
+
+	if(previousData && previousData->_keyFrame) {
+		if(!previousState) {
+			//e.g the previous block was restored by rewinding
+			previousState = GetBuffer(size);
+			previousData->DecodeState(*previousState);
+		}
+
+		DeltaBlock* previousDelta = previousData->_delta.get();
+		uint32_t chainLength = previousDelta ? previousDelta->ChainLength + 1 : 1;
+		uint32_t chainSize = previousDelta ? previousDelta->ChainSize : 0;
+		if(previousState->size() == size && chainLength <= RewindData::MaxChainLength && chainSize < GetKeyFrameSize(*previousData->_keyFrame)) {
+			//Most of the state (work ram, vram, aram, etc.) rarely changes between blocks, only keep what changed since the previous block
+			uint32_t deltaSize = EncodeDelta(state, previousState->data(), size, nullptr);
+			if(deltaSize <= size / RewindData::KeyFrameRatio) {
+				shared_ptr<vector<uint8_t>> delta = GetBuffer(deltaSize);
+				EncodeDelta(state, previousState->data(), size, delta->data());
+
+				_delta.reset(new DeltaBlock());
+				_delta->Data = Compress(delta->data(), deltaSize);
+				_delta->Previous = previousData->_delta;
+				_delta->ChainLength = chainLength;
+				_delta->ChainSize = chainSize + (uint32_t)_delta->Data->size();
+				_keyFrame = previousData->_keyFrame;
+			}
+		}
+	}
+
+	//Reuse the previous block's buffer, unless its key frame hasn't been compressed yet
+	if(previousState && previousState.use_count() == 1 && previousState->size() == size) {
+		_state = previousState;
+	} else {
+		_state = GetBuffer(size);
+	}
+	memcpy(_state->data(), state, size);
+
+	if(!_delta) {
+		//The state's layout changed, the chain is too long, or the state changed too much, start a new key frame
+		//It is compressed later, to avoid compressing the whole state on the emulation thread
+		_keyFrame.reset(new KeyFrame());
+		_keyFrame->State = _state;
+	}
+}
+
+shared_ptr<RewindData::KeyFrame> RewindData::GetUncompressedKeyFrame()
+{
+	if(_keyFrame && !_delta) {
+		auto lock = _keyFrame->Lock.AcquireSafe();
+		if(!_keyFrame->Data) {
+			return _keyFrame;
+		}
+	}
+	return nullptr;
+}
+
+void RewindData::CompressKeyFrame(KeyFrame &keyFrame)
+{
+	shared_ptr<vector<uint8_t>> state;
+	{
+		auto lock = keyFrame.Lock.AcquireSafe();
+		if(keyFrame.Data) {
+			return;
+		}
+		state = keyFrame.State;
+	}
+
+	//The lock isn't held while compressing, the state is never modified
+	shared_ptr<vector<uint8_t>> data = Compress(state->data(), (uint32_t)state->size());
+
+	auto lock = keyFrame.Lock.AcquireSafe();
+	if(!keyFrame.Data) {
+		keyFrame.Data = data;
+		keyFrame.State.reset();
+	}
 }
@@ -2,21 +2,96 @@
 #include "stdafx.h"
 #include <deque>
 #include "BaseControlDevice.h"
+#include "../Utilities/SimpleLock.h"
 
 class Console;
 
 class RewindData
 {
+public:
+	//Key frame at the start of a delta chain, shared by all the blocks of the chain
+	//Created uncompressed by SaveState, and compressed later by CompressKeyFrame (on the rewind manager's compression thread)
+	struct KeyFrame
+	{
+		SimpleLock Lock;
+		//Stored in the same format as Serializer::Save: [decompressed size][compressed size][zlib data]
+		shared_ptr<vector<uint8_t>> Data;
+		//Uncompressed state, released once the key frame is compressed
+		shared_ptr<vector<uint8_t>> State;
+	};
+
 private:
-	vector<uint8_t> SaveStateData;
+	//Compressed XOR delta against the previous block's state, stored as a list of [skip][length][xor bytes] runs
+	struct DeltaBlock
+	{
+		shared_ptr<vector<uint8_t>> Data;
+		//Delta of the previous block (null when the previous block is the key frame)
+		shared_ptr<DeltaBlock> Previous;
+		uint32_t ChainLength;
+		//Compressed size of all the deltas in the chain, up to this one
+		uint32_t ChainSize;
+	};
+
+	shared_ptr<KeyFrame> _keyFrame;
+
+	//Null for key frames
+	shared_ptr<DeltaBlock> _delta;
+
+	//Uncompressed state, only kept by the current block (to encode the next block's delta)
+	//Copies of a block (history, rewind backup, history viewer) never keep it, only moves do
+	shared_ptr<vector<uint8_t>> _state;
+
+	//Compressed save state built by GetStateData for delta blocks
+	shared_ptr<vector<uint8_t>> _stateData;
+
+	//Identical byte runs shorter than this are kept inside the current delta run
+	static constexpr uint32_t MaxGapSize = 16;
+	//A new key frame is created once a delta grows beyond 1/KeyFrameRatio of the state's size
+	static constexpr uint32_t KeyFrameRatio = 4;
+	//A new key frame is created once the chain's deltas take more space than its key frame (or after MaxChainLength deltas),
+	//this keeps the cost of decoding a block to about twice the cost of decoding its key frame
+	static constexpr uint32_t MaxChainLength = 300;
+	//Max number of unused buffers kept in the pool
+	static constexpr uint32_t MaxPoolSize = 32;
+
+	//Buffers released by the blocks that are dropped from the history are reused by new blocks
+	//Each buffer keeps a reference to the pool, so the pool outlives every buffer
+	struct BufferPool
+	{
+		SimpleLock Lock;
+		vector<vector<uint8_t>*> Buffers;
+		~BufferPool();
+	};
+	static shared_ptr<BufferPool> _bufferPool;
+
+	static shared_ptr<vector<uint8_t>> GetBuffer(uint32_t size);
+
+	static shared_ptr<vector<uint8_t>> Compress(uint8_t* data, uint32_t size);
+	static uint32_t GetDecompressedSize(vector<uint8_t> &compressedData);
+	static void Decompress(vector<uint8_t> &compressedData, vector<uint8_t> &output);
+
+	static uint32_t EncodeDelta(uint8_t* state, uint8_t* previousState, uint32_t size, uint8_t* output);
+	static void ApplyDelta(vector<uint8_t> &delta, vector<uint8_t> &stateData);
+	static uint32_t GetKeyFrameSize(KeyFrame &keyFrame);
+	void DecodeState(vector<uint8_t> &stateData);
 
 public:
 	std::deque<ControlDeviceState> InputLogs[BaseControlDevice::PortCount];
 	int32_t FrameCount = 0;
 	bool EndOfSegment = false;
 
+	RewindData() = default;
+	RewindData(const RewindData &other);
+	RewindData(RewindData &&other) = default;
+	RewindData& operator=(const RewindData &other);
+	RewindData& operator=(RewindData &&other) = default;
+
 	void GetStateData(stringstream &stateData);
 
 	void LoadState(shared_ptr<Console> &console);
-	void SaveState(shared_ptr<Console> &console);
+	void SaveState(shared_ptr<Console> &console, RewindData* previousData);
+
+	//Returns the key frame created by the last call to SaveState, if it hasn't been compressed yet
+	shared_ptr<KeyFrame> GetUncompressedKeyFrame();
+	static void CompressKeyFrame(KeyFrame &keyFrame);
 };
@@ -15,6 +15,8 @@ RewindManager::RewindManager(shared_ptr<Console> console)
 	_rewindState = RewindState::Stopped;
 	_framesToFastForward = 0;
 	_hasHistory = false;
+	_stopCompression = false;
+	_compressionThread = std::thread(&RewindManager::CompressionThread, this);
 	AddHistoryBlock();
 
 	_console->GetControlManager()->RegisterInputProvider(this);
@@ -25,6 +27,27 @@ RewindManager::~RewindManager()
 {
 	_console->GetControlManager()->UnregisterInputProvider(this);
 	_console->GetControlManager()->UnregisterInputRecorder(this);
+
+	_stopCompression = true;
+	_compressionSignal.Signal();
+	_compressionThread.join();
+}
+
+void RewindManager::CompressionThread()
+{
+	while(!_stopCompression) {
+		_compressionSignal.Wait();
+
+		vector<shared_ptr<RewindData::KeyFrame>> keyFrames;
+		{
+			auto lock = _compressionLock.AcquireSafe();
+			keyFrames.swap(_pendingKeyFrames);
+		}
+
+		for(shared_ptr<RewindData::KeyFrame> &keyFrame : keyFrames) {
+			RewindData::CompressKeyFrame(*keyFrame);
+		}
+	}
 }
 
 void RewindManager::ClearBuffer()
@@ -99,11 +122,20 @@ void RewindManager::AddHistoryBlock()
 			_history.pop_front();
 		}
 
+		RewindData newHistory;
+		newHistory.SaveState(_console, &_currentHistory);
+
+		shared_ptr<RewindData::KeyFrame> keyFrame = newHistory.GetUncompressedKeyFrame();
+		if(keyFrame) {
+			auto lock = _compressionLock.AcquireSafe();
+			_pendingKeyFrames.push_back(keyFrame);
+			_compressionSignal.Signal();
+		}
+
 		if(_currentHistory.FrameCount > 0) {
-			_history.push_back(_currentHistory);
+			_history.push_back(std::move(_currentHistory));
 		}
-		_currentHistory = RewindData();
-		_currentHistory.SaveState(_console);
+		_currentHistory = std::move(newHistory);
 	}
 }
 
@@ -6,6 +6,8 @@
 #include "IInputProvider.h"
 #include "IInputRecorder.h"
 #include "HistoryViewer.h"
+#include "../Utilities/AutoResetEvent.h"
+#include "../Utilities/SimpleLock.h"
 
 class Console;
 class EmuSettings;
@@ -48,6 +50,15 @@ private:
 	std::deque<int16_t> _audioHistory;
 	vector<int16_t> _audioHistoryBuilder;
 
+	//Key frames are compressed on a separate thread, to avoid stalling the emulation thread every time a key frame is created
+	std::thread _compressionThread;
+	AutoResetEvent _compressionSignal;
+	atomic<bool> _stopCompression;
+	SimpleLock _compressionLock;
+	vector<shared_ptr<RewindData::KeyFrame>> _pendingKeyFrames;
+
+	void CompressionThread();
+
 	void AddHistoryBlock();
 	void PopHistory();
 
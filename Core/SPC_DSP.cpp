@@ -3,6 +3,7 @@
 // snes_spc 0.9.0. http://www.slack.net/~ant/
 
 #include "SPC_DSP.h"
+#include "BenchmarkCounters.h"
 
 #include "blargg_endian.h"
 #include <string.h>
@@ -814,6 +815,8 @@ PHASE(31)  V(V4,0)       V(V1,2)\
 
 void SPC_DSP::run()
 {
+	BENCHMARK_SECTION(BenchmarkSection::Dsp);
+
 	int const phase = m.phase;
 	m.phase = (phase + 1) & 31;
 	switch (phase)
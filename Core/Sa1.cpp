@@ -797,6 +797,11 @@ CpuState Sa1::GetCpuState()
 	return _cpu->GetState();
 }
 
+CpuState& Sa1::GetCpuStateRef()
+{
+	return _cpu->GetStateRef();
+}
+
 uint16_t Sa1::ReadVector(uint16_t vector)
 {
 	switch(vector) {
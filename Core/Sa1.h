@@ -90,6 +90,7 @@ public:
 
 	DebugSa1State GetState();
 	CpuState GetCpuState();
+	CpuState& GetCpuStateRef();
 
 	uint16_t ReadVector(uint16_t vector);
 	MemoryMappings* GetMemoryMappings();
@@ -320,6 +320,7 @@ public:
 	void Exec();
 
 	CpuState GetState();
+	CpuState& GetStateRef() { return _state; }
 	uint64_t GetCycleCount();
 
 	template<uint64_t value>
@@ -1,9 +1,11 @@
 #include "stdafx.h"
 #include "ScaleFilter.h"
+#include "VideoFilterKernels.h"
 #include "../Utilities/xBRZ/xbrz.h"
 #include "../Utilities/HQX/hqx.h"
 #include "../Utilities/Scale2x/scalebit.h"
 #include "../Utilities/KreedSaiEagle/SaiEagle.h"
+#include "../Utilities/ThreadPool.h"
 
 bool ScaleFilter::_hqxInitDone = false;
 
@@ -33,12 +35,9 @@ void ScaleFilter::ApplyPrescaleFilter(uint32_t *inputArgbBuffer)
 	uint32_t* outputBuffer = _outputBuffer;
 
 	for(uint32_t y = 0; y < _height; y++) {
-		for(uint32_t x = 0; x < _width; x++) {
-			for(uint32_t i = 0; i < _filterScale; i++) {
-				*(outputBuffer++) = *inputArgbBuffer;
-			}
-			inputArgbBuffer++;
-		}
+		VideoFilterKernels::ScaleRow(inputArgbBuffer, outputBuffer, _width, _filterScale);
+		inputArgbBuffer += _width;
+		outputBuffer += _width*_filterScale;
 		for(uint32_t i = 1; i < _filterScale; i++) {
 			memcpy(outputBuffer, outputBuffer - _width*_filterScale, _width*_filterScale *4);
 			outputBuffer += _width*_filterScale;
@@ -46,6 +45,26 @@ void ScaleFilter::ApplyPrescaleFilter(uint32_t *inputArgbBuffer)
 	}
 }
 
+void ScaleFilter::ApplyFilterInBands(uint32_t height, std::function<void(int yFirst, int yLast)> filter)
+{
+	//Both filters read the neighboring source rows directly, so each band can be processed independently
+	//and the output is identical to processing the whole frame at once.
+	constexpr uint32_t minBandHeight = 16;
+	if(!_threadPool) {
+		_threadPool.reset(new ThreadPool(ThreadPool::GetDefaultThreadCount(4)));
+	}
+
+	uint32_t bandCount = std::max<uint32_t>(1, std::min<uint32_t>(_threadPool->GetThreadCount(), height / minBandHeight));
+	uint32_t bandHeight = (height + bandCount - 1) / bandCount;
+	_threadPool->Run(bandCount, [&](uint32_t band) {
+		uint32_t yFirst = band * bandHeight;
+		uint32_t yLast = std::min(height, yFirst + bandHeight);
+		if(yFirst < yLast) {
+			filter(yFirst, yLast);
+		}
+	});
+}
+
 void ScaleFilter::UpdateOutputBuffer(uint32_t width, uint32_t height)
 {
 	if(!_outputBuffer || width != _width || height != _height) {
@@ -61,9 +80,13 @@ uint32_t* ScaleFilter::ApplyFilter(uint32_t *inputArgbBuffer, uint32_t width, ui
 	UpdateOutputBuffer(width, height);
 
 	if(_scaleFilterType == ScaleFilterType::xBRZ) {
-		xbrz::scale(_filterScale, inputArgbBuffer, _outputBuffer, width, height, xbrz::ColorFormat::ARGB);
+		ApplyFilterInBands(height, [=](int yFirst, int yLast) {
+			xbrz::scale(_filterScale, inputArgbBuffer, _outputBuffer, width, height, xbrz::ColorFormat::ARGB, xbrz::ScalerCfg(), yFirst, yLast);
+		});
 	} else if(_scaleFilterType == ScaleFilterType::HQX) {
-		hqx(_filterScale, inputArgbBuffer, _outputBuffer, width, height);
+		ApplyFilterInBands(height, [=](int yFirst, int yLast) {
+			hqx(_filterScale, inputArgbBuffer, _outputBuffer, width, height, yFirst, yLast);
+		});
 	} else if(_scaleFilterType == ScaleFilterType::Scale2x) {
 		scale(_filterScale, _outputBuffer, width*sizeof(uint32_t)*_filterScale, inputArgbBuffer, width*sizeof(uint32_t), 4, width, height);
 	} else if(_scaleFilterType == ScaleFilterType::_2xSai) {
@@ -79,15 +102,12 @@ uint32_t* ScaleFilter::ApplyFilter(uint32_t *inputArgbBuffer, uint32_t width, ui
 	scanlineIntensity = 1.0 - scanlineIntensity;
 
 	if(scanlineIntensity < 1.0) {
+		ScanlineIntensityMultiplier multiplier;
+		VideoFilterKernels::GetIntensityMultiplier(scanlineIntensity, multiplier);
+
+		int xMax = width * _filterScale;
 		for(int y = 1, yMax = height * _filterScale; y < yMax; y += 2) {
-			for(int x = 0, xMax = width * _filterScale; x < xMax; x++) {
-				uint32_t &color = _outputBuffer[y*xMax + x];
-				uint8_t r = (color >> 16) & 0xFF, g = (color >> 8) & 0xFF, b = color & 0xFF;
-				r = (uint8_t)(r * scanlineIntensity);
-				g = (uint8_t)(g * scanlineIntensity);
-				b = (uint8_t)(b * scanlineIntensity);
-				color = 0xFF000000 | (r << 16) | (g << 8) | b;
-			}
+			VideoFilterKernels::ApplyScanlineIntensity(_outputBuffer + y*xMax, xMax, multiplier);
 		}
 	}
 
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "stdafx.h"
+#include <functional>
 #include "DefaultVideoFilter.h"
 
+class ThreadPool;
+
 class ScaleFilter
 {
 private:
@@ -13,7 +16,11 @@ private:
 	uint32_t _width = 0;
 	uint32_t _height = 0;
 
+	//Worker threads used to process xBRZ/HQX in horizontal bands
+	unique_ptr<ThreadPool> _threadPool;
+
 	void ApplyPrescaleFilter(uint32_t *inputArgbBuffer);
+	void ApplyFilterInBands(uint32_t height, std::function<void(int yFirst, int yLast)> filter);
 	void UpdateOutputBuffer(uint32_t width, uint32_t height);
 
 public:
@@ -45,6 +45,12 @@ string ScriptingContext::GetScriptName()
 
 void ScriptingContext::CallMemoryCallback(uint32_t addr, uint8_t &value, CallbackType type, CpuType cpuType)
 {
+	uint32_t page = GetCallbackPage(addr);
+	if(!(_callbackPages[(int)type][page >> 6] & (1ULL << (page & 0x3F)))) {
+		//No callback for this page
+		return;
+	}
+
 	_inExecOpEvent = type == CallbackType::CpuExec;
 	InternalCallMemoryCallback(addr, value, type, cpuType);
 	_inExecOpEvent = false;
@@ -97,6 +103,7 @@ void ScriptingContext::RegisterMemoryCallback(CallbackType type, int startAddr,
 	callback.Reference = reference;
 	callback.Type = cpuType;
 	_callbacks[(int)type].push_back(callback);
+	UpdateCallbackIndex(type);
 }
 
 void ScriptingContext::UnregisterMemoryCallback(CallbackType type, int startAddr, int endAddr, CpuType cpuType, int reference)
@@ -113,11 +120,55 @@ void ScriptingContext::UnregisterMemoryCallback(CallbackType type, int startAddr
 		MemoryCallback &callback = _callbacks[(int)type][i];
 		if(callback.Reference == reference && callback.Type == cpuType && (int)callback.StartAddress == startAddr && (int)callback.EndAddress == endAddr) {
 			_callbacks[(int)type].erase(_callbacks[(int)type].begin() + i);
+			UpdateCallbackIndex(type);
 			break;
 		}
 	}
 }
 
+void ScriptingContext::UpdateCallbackIndex(CallbackType type)
+{
+	vector<MemoryCallback> &callbacks = _callbacks[(int)type];
+	uint64_t* pages = _callbackPages[(int)type];
+	vector<uint32_t> &offsets = _pageOffsets[(int)type];
+	vector<uint32_t> &pageCallbacks = _pageCallbacks[(int)type];
+
+	memset(pages, 0, sizeof(_callbackPages[0]));
+
+	//Memory operations are never above $FFFFFF
+	auto getPageRange = [](MemoryCallback &callback, uint32_t &first, uint32_t &last) {
+		first = callback.StartAddress <= 0xFFFFFF ? GetCallbackPage(callback.StartAddress) : 1;
+		last = callback.StartAddress <= 0xFFFFFF ? GetCallbackPage(std::min<uint32_t>(callback.EndAddress, 0xFFFFFF)) : 0;
+	};
+
+	//Count the callbacks in each page, then fill each page's list
+	vector<uint32_t> counts(CallbackPageCount, 0);
+	uint32_t first, last;
+	for(MemoryCallback &callback : callbacks) {
+		getPageRange(callback, first, last);
+		for(uint32_t page = first; page <= last; page++) {
+			counts[page]++;
+		}
+	}
+
+	offsets.assign(CallbackPageCount + 1, 0);
+	for(uint32_t page = 0; page < CallbackPageCount; page++) {
+		offsets[page + 1] = offsets[page] + counts[page];
+		if(counts[page]) {
+			pages[page >> 6] |= 1ULL << (page & 0x3F);
+		}
+	}
+
+	pageCallbacks.resize(offsets[CallbackPageCount]);
+	vector<uint32_t> pos(offsets.begin(), offsets.end() - 1);
+	for(uint32_t i = 0; i < (uint32_t)callbacks.size(); i++) {
+		getPageRange(callbacks[i], first, last);
+		for(uint32_t page = first; page <= last; page++) {
+			pageCallbacks[pos[page]++] = i;
+		}
+	}
+}
+
 void ScriptingContext::RegisterEventCallback(EventType type, int reference)
 {
 	_eventCallbacks[(int)type].push_back(reference);
@@ -48,6 +48,17 @@ protected:
 	vector<MemoryCallback> _callbacks[3];
 	vector<int> _eventCallbacks[(int)EventType::EventTypeSize];
 
+	//Memory callbacks are indexed by 4 KB page (address bits 12-23), for all CPU types
+	//_callbackPages has a bit set for each page that has at least one callback
+	//_pageCallbacks contains the callback indexes for each page (from _pageOffsets[page] to _pageOffsets[page + 1]), in registration order
+	static constexpr uint32_t CallbackPageCount = 0x1000;
+	uint64_t _callbackPages[3][CallbackPageCount / 64] = {};
+	vector<uint32_t> _pageOffsets[3];
+	vector<uint32_t> _pageCallbacks[3];
+
+	void UpdateCallbackIndex(CallbackType type);
+	static uint32_t GetCallbackPage(uint32_t addr) { return (addr >> 12) & (CallbackPageCount - 1); }
+
 	virtual void InternalCallMemoryCallback(uint32_t addr, uint8_t &value, CallbackType type, CpuType cpuType) = 0;
 	virtual int InternalCallEventCallback(EventType type) = 0;
 
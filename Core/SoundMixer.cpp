@@ -18,29 +18,64 @@ SoundMixer::SoundMixer(Console *console)
 	_audioDevice = nullptr;
 	_resampler.reset(new SoundResampler(console));
 	_sampleBuffer = new int16_t[0x10000];
+	_mixBuffer = new int16_t[0x10000];
+	_mixerSamples.SetCapacity(MixerBufferSize);
+	_mixerBatches.SetCapacity(256);
+	_stopMixer = false;
+	_mixerGeneration = 0;
+	_mixerLatency = 0;
+	_mixerOverrunCount = 0;
 }
 
 SoundMixer::~SoundMixer()
 {
+	StopThread();
 	delete[] _sampleBuffer;
+	delete[] _mixBuffer;
+}
+
+void SoundMixer::StartThread()
+{
+	if(!_mixerThread.joinable()) {
+		_stopMixer = false;
+		_mixerThread = std::thread(&SoundMixer::MixerThread, this);
+	}
+}
+
+void SoundMixer::StopThread()
+{
+	if(_mixerThread.joinable()) {
+		_stopMixer = true;
+		_mixerSignal.Signal();
+		_mixerThread.join();
+	}
 }
 
 void SoundMixer::RegisterAudioDevice(IAudioDevice *audioDevice)
 {
+	auto lock = _audioDeviceLock.AcquireSafe();
 	_audioDevice = audioDevice;
 }
 
 AudioStatistics SoundMixer::GetStatistics()
 {
+	AudioStatistics stats;
 	if(_audioDevice) {
-		return _audioDevice->GetStatistics();
-	} else {
-		return AudioStatistics();
+		stats = _audioDevice->GetStatistics();
 	}
+	stats.MixerLatency = _mixerLatency;
+	stats.MixerOverrunCount = _mixerOverrunCount;
+	return stats;
 }
 
 void SoundMixer::StopAudio(bool clearBuffer)
 {
+	auto lock = _audioDeviceLock.AcquireSafe();
+
+	//Anything still waiting to be mixed is discarded, otherwise the mixer thread would restart playback
+	//Batches are tagged with the generation they were queued in, so only batches queued before this call are dropped
+	_mixerGeneration++;
+
 	if(_audioDevice) {
 		if(clearBuffer) {
 			_audioDevice->Stop();
@@ -54,24 +89,11 @@ void SoundMixer::PlayAudioBuffer(int16_t* samples, uint32_t sampleCount, uint32_
 {
 	AudioConfig cfg = _console->GetSettings()->GetAudioConfig();
 
-	if(cfg.EnableEqualizer) {
-		ProcessEqualizer(samples, sampleCount);
-	}
-
-	uint32_t masterVolume = cfg.MasterVolume;
-	if(_console->GetSettings()->CheckFlag(EmulationFlags::InBackground)) {
-		if(cfg.MuteSoundInBackground) {
-			masterVolume = 0;
-		} else if(cfg.ReduceSoundInBackground) {
-			masterVolume = cfg.VolumeReduction == 100 ? 0 : masterVolume * (100 - cfg.VolumeReduction) / 100;
-		}
-	} else if(cfg.ReduceSoundInFastForward && _console->GetSettings()->CheckFlag(EmulationFlags::TurboOrRewind)) {
-		masterVolume = cfg.VolumeReduction == 100 ? 0 : masterVolume * (100 - cfg.VolumeReduction) / 100;
-	}
-
 	_leftSample = samples[0];
 	_rightSample = samples[1];
 
+	//Everything that depends on the emulation's state (SGB/MSU-1 audio, rewind) is done here,
+	//the rest of the processing is done on the mixer thread
 	int16_t *out = _sampleBuffer;
 	uint32_t count = _resampler->Resample(samples, sampleCount, sourceRate, cfg.SampleRate, out);
 
@@ -85,37 +107,110 @@ void SoundMixer::PlayAudioBuffer(int16_t* samples, uint32_t sampleCount, uint32_
 	if(msu1) {
 		msu1->MixAudio(out, count, cfg.SampleRate);
 	}
-	
-	if(masterVolume < 100) {
-		//Apply volume if not using the default value
-		for(uint32_t i = 0; i < count * 2; i++) {
-			out[i] = (int32_t)out[i] * (int32_t)masterVolume / 100;
-		}
-	}
 
 	shared_ptr<RewindManager> rewindManager = _console->GetRewindManager();
 	if(!_console->IsRunAheadFrame() && rewindManager && rewindManager->SendAudio(out, count)) {
-		bool isRecording = _waveRecorder || _console->GetVideoRenderer()->IsRecording();
-		if(isRecording) {
-			if(_waveRecorder) {
-				_waveRecorder->WriteSamples(out, count, cfg.SampleRate, true);
-			}
-			_console->GetVideoRenderer()->AddRecordingSound(out, count, cfg.SampleRate);
+		if(UseMixerThread()) {
+			QueueAudio(out, count, cfg.SampleRate);
+		} else {
+			auto lock = _audioDeviceLock.AcquireSafe();
+			MixAudio(out, count, cfg.SampleRate);
 		}
+	}
+}
+
+bool SoundMixer::UseMixerThread()
+{
+	IAudioDevice* audioDevice = _audioDevice;
+	return _mixerThread.joinable() && !(audioDevice && audioDevice->RequiresSynchronousOutput());
+}
 
-		if(_audioDevice) {
-			if(!cfg.EnableAudio) {
-				_audioDevice->Stop();
-				return;
+void SoundMixer::QueueAudio(int16_t* samples, uint32_t sampleCount, uint32_t sampleRate)
+{
+	//Never block the emulation thread - if the mixer thread is too far behind, the batch is dropped
+	if(_mixerSamples.GetWriteSpace() < sampleCount * 2 || _mixerBatches.GetWriteSpace() == 0) {
+		_mixerOverrunCount++;
+		return;
+	}
+
+	_mixerSamples.Write(samples, sampleCount * 2);
+	_mixerBatches.Push({ sampleCount, sampleRate, _mixerGeneration, _mixerTimer.GetElapsedMS() });
+	_mixerSignal.Signal();
+}
+
+void SoundMixer::MixerThread()
+{
+	while(!_stopMixer) {
+		_mixerSignal.Wait();
+
+		AudioBatch batch;
+		while(!_stopMixer && _mixerBatches.Pop(batch)) {
+			_mixerSamples.Read(_mixBuffer, batch.SampleCount * 2);
+
+			auto lock = _audioDeviceLock.AcquireSafe();
+			if(batch.Generation != _mixerGeneration) {
+				//Queued before StopAudio was called, drop it
+				continue;
 			}
 
-			_audioDevice->PlayBuffer(out, count, cfg.SampleRate, true);
-			_audioDevice->ProcessEndOfFrame();
+			//Average time spent between the emulation thread and the mixer thread
+			_mixerLatency = _mixerLatency * 0.95 + (_mixerTimer.GetElapsedMS() - batch.QueueTime) * 0.05;
+
+			MixAudio(_mixBuffer, batch.SampleCount, batch.SampleRate);
+		}
+	}
+}
+
+void SoundMixer::MixAudio(int16_t* samples, uint32_t sampleCount, uint32_t sampleRate)
+{
+	AudioConfig cfg = _console->GetSettings()->GetAudioConfig();
+
+	if(cfg.EnableEqualizer) {
+		ProcessEqualizer(samples, sampleCount, sampleRate);
+	}
+
+	uint32_t masterVolume = cfg.MasterVolume;
+	if(_console->GetSettings()->CheckFlag(EmulationFlags::InBackground)) {
+		if(cfg.MuteSoundInBackground) {
+			masterVolume = 0;
+		} else if(cfg.ReduceSoundInBackground) {
+			masterVolume = cfg.VolumeReduction == 100 ? 0 : masterVolume * (100 - cfg.VolumeReduction) / 100;
+		}
+	} else if(cfg.ReduceSoundInFastForward && _console->GetSettings()->CheckFlag(EmulationFlags::TurboOrRewind)) {
+		masterVolume = cfg.VolumeReduction == 100 ? 0 : masterVolume * (100 - cfg.VolumeReduction) / 100;
+	}
+
+	if(masterVolume < 100) {
+		//Apply volume if not using the default value
+		for(uint32_t i = 0; i < sampleCount * 2; i++) {
+			samples[i] = (int32_t)samples[i] * (int32_t)masterVolume / 100;
 		}
 	}
+
+	shared_ptr<VideoRenderer> videoRenderer = _console->GetVideoRenderer();
+	bool isRecording = _waveRecorder || (videoRenderer && videoRenderer->IsRecording());
+	if(isRecording) {
+		shared_ptr<WaveRecorder> waveRecorder = _waveRecorder;
+		if(waveRecorder) {
+			waveRecorder->WriteSamples(samples, sampleCount, sampleRate, true);
+		}
+		if(videoRenderer) {
+			videoRenderer->AddRecordingSound(samples, sampleCount, sampleRate);
+		}
+	}
+
+	if(_audioDevice) {
+		if(!cfg.EnableAudio) {
+			_audioDevice->Stop();
+			return;
+		}
+
+		_audioDevice->PlayBuffer(samples, sampleCount, sampleRate, true);
+		_audioDevice->ProcessEndOfFrame();
+	}
 }
 
-void SoundMixer::ProcessEqualizer(int16_t* samples, uint32_t sampleCount)
+void SoundMixer::ProcessEqualizer(int16_t* samples, uint32_t sampleCount, uint32_t sampleRate)
 {
 	AudioConfig cfg = _console->GetSettings()->GetAudioConfig();
 	if(!_equalizer) {
@@ -127,7 +222,7 @@ void SoundMixer::ProcessEqualizer(int16_t* samples, uint32_t sampleCount)
 		cfg.Band11Gain, cfg.Band12Gain, cfg.Band13Gain, cfg.Band14Gain, cfg.Band15Gain,
 		cfg.Band16Gain, cfg.Band17Gain, cfg.Band18Gain, cfg.Band19Gain, cfg.Band20Gain
 	};
-	_equalizer->UpdateEqualizers(bandGains, Spc::SpcSampleRate);
+	_equalizer->UpdateEqualizers(bandGains, sampleRate);
 	_equalizer->ApplyEqualizer(sampleCount, samples);
 }
 
@@ -138,11 +233,13 @@ double SoundMixer::GetRateAdjustment()
 
 void SoundMixer::StartRecording(string filepath)
 {
+	auto lock = _audioDeviceLock.AcquireSafe();
 	_waveRecorder.reset(new WaveRecorder(filepath, _console->GetSettings()->GetAudioConfig().SampleRate, true));
 }
 
 void SoundMixer::StopRecording()
 {
+	auto lock = _audioDeviceLock.AcquireSafe();
 	_waveRecorder.reset();
 }
 
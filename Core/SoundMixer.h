@@ -1,15 +1,30 @@
 #pragma once
 #include "stdafx.h"
+#include <thread>
 #include "IAudioDevice.h"
+#include "../Utilities/SpscRingBuffer.h"
+#include "../Utilities/AutoResetEvent.h"
+#include "../Utilities/SimpleLock.h"
+#include "../Utilities/Timer.h"
 
 class Console;
 class Equalizer;
 class SoundResampler;
 class WaveRecorder;
 
+struct AudioBatch
+{
+	uint32_t SampleCount;
+	uint32_t SampleRate;
+	uint32_t Generation;
+	double QueueTime;
+};
+
 class SoundMixer 
 {
 private:
+	static constexpr uint32_t MixerBufferSize = 0x20000;
+
 	IAudioDevice *_audioDevice;
 	Console *_console;
 	unique_ptr<Equalizer> _equalizer;
@@ -20,12 +35,32 @@ private:
 	int16_t _leftSample = 0;
 	int16_t _rightSample = 0;
 
-	void ProcessEqualizer(int16_t *samples, uint32_t sampleCount);
+	//Post-processing and device output run on the mixer thread, fed by the emulation thread
+	std::thread _mixerThread;
+	AutoResetEvent _mixerSignal;
+	atomic<bool> _stopMixer;
+	atomic<uint32_t> _mixerGeneration;
+	SimpleLock _audioDeviceLock;
+	SpscRingBuffer<int16_t> _mixerSamples;
+	SpscRingBuffer<AudioBatch> _mixerBatches;
+	int16_t *_mixBuffer = nullptr;
+	Timer _mixerTimer;
+	atomic<double> _mixerLatency;
+	atomic<uint32_t> _mixerOverrunCount;
+
+	void ProcessEqualizer(int16_t *samples, uint32_t sampleCount, uint32_t sampleRate);
+	bool UseMixerThread();
+	void MixerThread();
+	void QueueAudio(int16_t *samples, uint32_t sampleCount, uint32_t sampleRate);
+	void MixAudio(int16_t *samples, uint32_t sampleCount, uint32_t sampleRate);
 
 public:
 	SoundMixer(Console *console);
 	~SoundMixer();
 
+	void StartThread();
+	void StopThread();
+
 	void PlayAudioBuffer(int16_t *samples, uint32_t sampleCount, uint32_t sourceRate);
 	void StopAudio(bool clearBuffer = false);
 
@@ -5,7 +5,7 @@
 #include "EmuSettings.h"
 #include "SoundMixer.h"
 #include "VideoRenderer.h"
-#include "../Utilities/HermiteResampler.h"
+#include "../Utilities/PolyphaseResampler.h"
 
 SoundResampler::SoundResampler(Console *console)
 {
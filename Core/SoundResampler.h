@@ -1,6 +1,6 @@
 #pragma once
 #include "stdafx.h"
-#include "../Utilities/HermiteResampler.h"
+#include "../Utilities/PolyphaseResampler.h"
 
 class Console;
 
@@ -14,7 +14,7 @@ private:
 	double _prevSpcSampleRate = 0;
 	int32_t _underTarget = 0;
 
-	HermiteResampler _resampler;
+	PolyphaseResampler _resampler;
 
 	double GetTargetRateAdjustment();
 	void UpdateTargetSampleRate(uint32_t sourceRate, uint32_t sampleRate);
@@ -12,6 +12,7 @@
 #include "SPC_DSP.h"
 #define Spc DummySpc
 #endif
+#include "BenchmarkCounters.h"
 #include "../Utilities/Serializer.h"
 
 Spc::Spc(Console* console)
@@ -351,6 +352,10 @@ void Spc::Run()
 		return;
 	}
 
+#ifndef DUMMYSPC
+	BENCHMARK_SECTION(BenchmarkSection::Spc);
+#endif
+
 	uint64_t targetCycle = (uint64_t)(_memoryManager->GetMasterClock() * _clockRatio);
 	while(_state.Cycle < targetCycle) {
 		ProcessCycle();
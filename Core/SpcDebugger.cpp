@@ -5,6 +5,7 @@
 #include "Spc.h"
 #include "TraceLogger.h"
 #include "CallstackManager.h"
+#include "Profiler.h"
 #include "BreakpointManager.h"
 #include "MemoryManager.h"
 #include "Debugger.h"
@@ -23,14 +24,16 @@ SpcDebugger::SpcDebugger(Debugger* debugger)
 	_memoryManager = debugger->GetConsole()->GetMemoryManager().get();
 	_settings = debugger->GetConsole()->GetSettings().get();
 
-	_callstackManager.reset(new CallstackManager(debugger));
+	_callstackManager.reset(new CallstackManager(debugger, CpuType::Spc));
 	_breakpointManager.reset(new BreakpointManager(debugger, CpuType::Spc));
 	_step.reset(new StepRequest());
 }
 
 void SpcDebugger::Reset()
 {
-	_callstackManager.reset(new CallstackManager(_debugger));
+	shared_ptr<CallstackManager> prevCallstackManager = _callstackManager;
+	_callstackManager.reset(new CallstackManager(_debugger, CpuType::Spc));
+	_callstackManager->GetProfiler()->CopyMode(prevCallstackManager->GetProfiler());
 	_prevOpCode = 0xFF;
 }
 
@@ -63,14 +66,18 @@ void SpcDebugger::ProcessRead(uint16_t addr, uint8_t value, MemoryOperationType
 			//JSR, BRK
 			uint8_t opSize = DisassemblyInfo::GetOpSize(_prevOpCode, 0, CpuType::Spc);
 			uint16_t returnPc = _prevProgramCounter + opSize;
-			AddressInfo src = _spc->GetAbsoluteAddress(_prevProgramCounter);
 			AddressInfo ret = _spc->GetAbsoluteAddress(returnPc);
-			_callstackManager->Push(src, _prevProgramCounter, addressInfo, spcState.PC, ret, returnPc, StackFrameFlags::None);
+			_callstackManager->Push(_prevProgramCounter, addressInfo, spcState.PC, ret, returnPc, StackFrameFlags::None);
 		} else if(_prevOpCode == 0x6F || _prevOpCode == 0x7F) {
 			//RTS, RTI
 			_callstackManager->Pop(addressInfo, spcState.PC);
 		}
 
+		Profiler* profiler = _callstackManager->GetProfiler();
+		if(profiler->IsSampling()) {
+			profiler->ProcessInstruction(addressInfo, spcState.Cycle);
+		}
+
 		if(_step->BreakAddress == (int32_t)spcState.PC && (_prevOpCode == 0x6F || _prevOpCode == 0x7F)) {
 			//RTS/RTI found, if we're on the expected return address, break immediately (for step over/step out)
 			_step->StepCount = 0;
@@ -10,7 +10,7 @@
 #include "GbPpu.h"
 #include "MessageManager.h"
 #include "../Utilities/HexUtilities.h"
-#include "../Utilities/HermiteResampler.h"
+#include "../Utilities/PolyphaseResampler.h"
 
 SuperGameboy::SuperGameboy(Console* console) : BaseCoprocessor(SnesMemoryType::Register)
 {
@@ -1,7 +1,7 @@
 #pragma once
 #include "stdafx.h"
 #include "BaseCoprocessor.h"
-#include "../Utilities/HermiteResampler.h"
+#include "../Utilities/PolyphaseResampler.h"
 
 class Console;
 class MemoryManager;
@@ -40,7 +40,7 @@ private:
 	uint16_t _readPosition = 0;
 	uint8_t _lcdBuffer[4][1280] = {};
 	
-	HermiteResampler _resampler;
+	PolyphaseResampler _resampler;
 	int16_t* _mixBuffer = nullptr;
 	uint32_t _mixSampleCount = 0;
 
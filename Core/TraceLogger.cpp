@@ -26,26 +26,21 @@ TraceLogger::TraceLogger(Debugger* debugger, shared_ptr<Console> console)
 	_currentPos = 0;
 	_logCount = 0;
 	_logToFile = false;
+	_binaryLog = false;
 	_pendingLog = false;
 
-	_stateCache = new DebugState[TraceLogger::ExecutionLogSize];
-	_stateCacheCopy = new DebugState[TraceLogger::ExecutionLogSize];
-	_disassemblyCache = new DisassemblyInfo[TraceLogger::ExecutionLogSize];
-	_disassemblyCacheCopy = new DisassemblyInfo[TraceLogger::ExecutionLogSize];
-	_logCpuType = new CpuType[TraceLogger::ExecutionLogSize];
-	_logCpuTypeCopy = new CpuType[TraceLogger::ExecutionLogSize];
+	_stopWriter = false;
+
+	_rowCache = new TraceLogRow[TraceLogger::ExecutionLogSize];
+	_rowCacheCopy = new TraceLogRow[TraceLogger::ExecutionLogSize];
 }
 
 TraceLogger::~TraceLogger()
 {
 	StopLogging();
 
-	delete[] _stateCache;
-	delete[] _stateCacheCopy;
-	delete[] _disassemblyCache;
-	delete[] _disassemblyCacheCopy;
-	delete[] _logCpuType;
-	delete[] _logCpuTypeCopy;
+	delete[] _rowCache;
+	delete[] _rowCacheCopy;
 }
 
 template<typename T>
@@ -69,6 +64,7 @@ void TraceLogger::WriteValue(string &output, string value, RowPart& rowPart)
 
 void TraceLogger::SetOptions(TraceLoggerOptions options)
 {
+	auto formatLock = _formatLock.AcquireSafe();
 	_options = options;
 	
 	_logCpu[(int)CpuType::Cpu] = options.LogCpu;
@@ -82,7 +78,6 @@ void TraceLogger::SetOptions(TraceLoggerOptions options)
 	string condition = _options.Condition;
 	string format = _options.Format;
 
-	auto lock = _lock.AcquireSafe();
 	/*_conditionData = ExpressionData();
 	if(!condition.empty()) {
 		bool success = false;
@@ -98,6 +93,25 @@ void TraceLogger::SetOptions(TraceLoggerOptions options)
 	ParseFormatString(_gsuRowParts, "[PC,6h]   [ByteCode,11h] [Disassembly] [Align,50] SRC:[X,2] DST:[Y,2] R0:[A,2h] H:[Cycle,3] V:[Scanline,3]");
 	ParseFormatString(_cx4RowParts, "[PC,6h]   [ByteCode,11h] [Disassembly] [Align,45] [A,2h] H:[Cycle,3] V:[Scanline,3]");
 	ParseFormatString(_gbRowParts, "[PC,6h]   [ByteCode,11h] [Disassembly] [Align,45] A:[A,2h] B:[B,2h] C:[C,2h] D:[D,2h] E:[E,2h] HL:[H,2h][L,2h] F:[F,2h] SP:[SP,4h] CYC:[Cycle,3] LY:[Scanline,3]");
+
+	//Effective addresses & memory values are only read when logging if the CPU's format displays them
+	vector<RowPart>* cpuRowParts[] = { &_rowParts, &_spcRowParts, &_dspRowParts, &_rowParts, &_gsuRowParts, &_cx4RowParts, &_gbRowParts };
+	CpuType cpuTypes[] = { CpuType::Cpu, CpuType::Spc, CpuType::NecDsp, CpuType::Sa1, CpuType::Gsu, CpuType::Cx4, CpuType::Gameboy };
+	for(int i = 0; i < 7; i++) {
+		bool showMemoryValue = HasRowPart(*cpuRowParts[i], RowDataType::MemoryValue);
+		_logEffectiveAddress[(int)cpuTypes[i]] = showMemoryValue || HasRowPart(*cpuRowParts[i], RowDataType::EffectiveAddress);
+		_logMemoryValue[(int)cpuTypes[i]] = showMemoryValue;
+	}
+}
+
+bool TraceLogger::HasRowPart(vector<RowPart> &rowParts, RowDataType dataType)
+{
+	for(RowPart &part : rowParts) {
+		if(part.DataType == dataType) {
+			return true;
+		}
+	}
+	return false;
 }
 
 void TraceLogger::ParseFormatString(vector<RowPart> &rowParts, string format)
@@ -188,33 +202,244 @@ void TraceLogger::ParseFormatString(vector<RowPart> &rowParts, string format)
 	}
 }
 
-void TraceLogger::StartLogging(string filename)
+void TraceLogger::StartLogging(string filename, bool binaryFormat)
 {
+	StopLogging();
+
 	_outputBuffer.clear();
 	_outputFile.open(filename, ios::out | ios::binary);
+	_extraInfo.clear();
+	if(binaryFormat) {
+		TraceLogFileHeader header = {};
+		memcpy(header.Magic, "MTRC", sizeof(header.Magic));
+		header.Version = TraceLogger::BinaryLogVersion;
+		header.RowSize = (uint32_t)sizeof(TraceLogRow);
+		_outputFile.write((char*)&header, sizeof(header));
+	}
+	_writeQueue.SetCapacity(TraceLogger::WriteQueueSize);
+	_stopWriter = false;
+	_writerThread = std::thread(&TraceLogger::WriterThread, this, binaryFormat);
+
+	auto lock = _lock.AcquireSafe();
 	_logToFile = true;
+	_binaryLog = binaryFormat;
 }
 
 void TraceLogger::StopLogging()
 {
-	if(_logToFile) {
+	{
+		auto lock = _lock.AcquireSafe();
+		if(!_logToFile) {
+			return;
+		}
 		_logToFile = false;
-		if(_outputFile) {
-			if(!_outputBuffer.empty()) {
-				_outputFile << _outputBuffer;
+		_binaryLog = false;
+	}
+
+	//The writer thread formats & writes the remaining rows before exiting
+	_stopWriter = true;
+	_writerSignal.Signal();
+	_writerThread.join();
+
+	_outputFile.close();
+	_writeQueue.SetCapacity(0);
+}
+
+void TraceLogger::WriterThread(bool binaryFormat)
+{
+	vector<TraceLogRow> rows(TraceLogger::WriteBatchSize);
+	while(true) {
+		bool stop = _stopWriter;
+		uint32_t count = _writeQueue.Read(rows.data(), TraceLogger::WriteBatchSize);
+		if(count == 0) {
+			if(stop) {
+				break;
+			}
+			_writerSignal.Wait(10);
+			continue;
+		}
+
+		if(binaryFormat) {
+			//Rows are written as-is, ConvertBinaryLog formats them later
+			for(uint32_t i = 0; i < count; i++) {
+				WriteBinaryRow(rows[i]);
+			}
+		} else {
+			auto formatLock = _formatLock.AcquireSafe();
+			for(uint32_t i = 0; i < count; i++) {
+				if(rows[i].IsExtraInfo) {
+					auto lock = _extraInfoLock.AcquireSafe();
+					WriteExtraInfo(_outputBuffer, _extraInfo.front());
+					_extraInfo.pop_front();
+				} else {
+					GetTraceRow(_outputBuffer, rows[i]);
+				}
+			}
+		}
+
+		if(_outputBuffer.size() > 32768) {
+			_outputFile << _outputBuffer;
+			_outputBuffer.clear();
+		}
+	}
+
+	if(_outputFile && !_outputBuffer.empty()) {
+		_outputFile << _outputBuffer;
+	}
+	_outputBuffer.clear();
+}
+
+uint32_t TraceLogger::GetBinaryStateSize(TraceLogRow &row)
+{
+	if(row.IsExtraInfo) {
+		return 0;
+	}
+
+	switch(row.Type) {
+		case CpuType::Cpu: case CpuType::Sa1: return sizeof(CpuState);
+		case CpuType::Spc: return sizeof(SpcState);
+		case CpuType::NecDsp: return sizeof(NecDspState);
+		case CpuType::Gsu: return sizeof(GsuState);
+		case CpuType::Cx4: return sizeof(Cx4State);
+		case CpuType::Gameboy: return sizeof(GbCpuState);
+	}
+	return 0;
+}
+
+void TraceLogger::WriteBinaryRow(TraceLogRow &row)
+{
+	//Only the state of the CPU that ran the instruction is written, instead of the whole union
+	constexpr uint32_t stateOffset = offsetof(TraceLogRow, State);
+	constexpr uint32_t tailOffset = stateOffset + sizeof(TraceLogCpuState);
+	_outputBuffer.append((char*)&row, stateOffset);
+	_outputBuffer.append((char*)&row.State, GetBinaryStateSize(row));
+	_outputBuffer.append((char*)&row + tailOffset, sizeof(TraceLogRow) - tailOffset);
+
+	if(row.IsExtraInfo) {
+		auto lock = _extraInfoLock.AcquireSafe();
+		string &extraInfo = _extraInfo.front();
+		uint32_t length = (uint32_t)extraInfo.size();
+		_outputBuffer.append((char*)&length, sizeof(length));
+		_outputBuffer += extraInfo;
+		_extraInfo.pop_front();
+	}
+}
+
+void TraceLogger::WriteExtraInfo(string &output, string &extraInfo)
+{
+	output += "[" + extraInfo + "]" + (_options.UseWindowsEol ? "\r\n" : "\n");
+}
+
+bool TraceLogger::ConvertBinaryLog(string inputFile, string outputFile)
+{
+	ifstream input(inputFile, ios::in | ios::binary);
+	if(!input) {
+		return false;
+	}
+
+	TraceLogFileHeader header = {};
+	input.read((char*)&header, sizeof(header));
+	if(!input || memcmp(header.Magic, "MTRC", 4) != 0 || header.Version != TraceLogger::BinaryLogVersion || header.RowSize != sizeof(TraceLogRow)) {
+		return false;
+	}
+
+	ofstream output(outputFile, ios::out | ios::binary);
+	if(!output) {
+		return false;
+	}
+
+	//Rows are formatted with the current options, format strings and labels
+	//The format lock is only held while formatting each batch, so the trace logger window isn't blocked while a large log is converted
+	vector<TraceLogRow> rows(TraceLogger::WriteBatchSize);
+	vector<string> extraInfo(TraceLogger::WriteBatchSize);
+	string buffer;
+	bool endOfFile = false;
+	while(!endOfFile) {
+		uint32_t count = 0;
+		while(count < TraceLogger::WriteBatchSize) {
+			if(!ReadBinaryRow(input, rows[count], extraInfo[count])) {
+				endOfFile = true;
+				break;
 			}
-			_outputFile.close();
+			count++;
+		}
+
+		{
+			auto formatLock = _formatLock.AcquireSafe();
+			for(uint32_t i = 0; i < count; i++) {
+				if(rows[i].IsExtraInfo) {
+					WriteExtraInfo(buffer, extraInfo[i]);
+				} else {
+					GetTraceRow(buffer, rows[i]);
+				}
+			}
+		}
+
+		output << buffer;
+		buffer.clear();
+	}
+	return true;
+}
+
+bool TraceLogger::ReadBinaryRow(ifstream &input, TraceLogRow &row, string &extraInfo)
+{
+	constexpr uint32_t stateOffset = offsetof(TraceLogRow, State);
+	constexpr uint32_t tailOffset = stateOffset + sizeof(TraceLogCpuState);
+	if(!input.read((char*)&row, stateOffset)) {
+		return false;
+	}
+
+	if(!row.IsExtraInfo && ((int)row.Type < 0 || row.Type > DebugUtilities::GetLastCpuType())) {
+		//Corrupted row
+		return false;
+	}
+	input.read((char*)&row.State, GetBinaryStateSize(row));
+	input.read((char*)&row + tailOffset, sizeof(TraceLogRow) - tailOffset);
+	if(!input) {
+		return false;
+	}
+
+	if(row.IsExtraInfo) {
+		uint32_t length = 0;
+		input.read((char*)&length, sizeof(length));
+		if(!input || length > 0x10000) {
+			return false;
+		}
+		extraInfo.resize(length);
+		input.read(&extraInfo[0], length);
+		if(!input) {
+			return false;
 		}
 	}
+	return true;
+}
+
+void TraceLogger::QueueRow(TraceLogRow &row)
+{
+	if(!_writeQueue.Push(row)) {
+		//Queue is full, wait for the writer thread to catch up
+		_writerSignal.Signal();
+		while(!_writeQueue.Push(row)) {
+			std::this_thread::yield();
+		}
+	} else if(_writeQueue.GetReadCount() == TraceLogger::WriteQueueSize / 2) {
+		_writerSignal.Signal();
+	}
 }
 
 void TraceLogger::LogExtraInfo(const char *log, uint32_t cycleCount)
 {
+	auto lock = _lock.AcquireSafe();
 	if(_logToFile && _options.ShowExtraInfo) {
-		//Flush current buffer
-		_outputFile << _outputBuffer;
-		_outputBuffer.clear();
-		_outputFile << "[" << log << " - Cycle: " << std::to_string(cycleCount) << "]" << (_options.UseWindowsEol ? "\r\n" : "\n");
+		{
+			auto extraInfoLock = _extraInfoLock.AcquireSafe();
+			_extraInfo.push_back(string(log) + " - Cycle: " + std::to_string(cycleCount));
+		}
+
+		TraceLogRow row;
+		memset((void*)&row, 0, sizeof(row));
+		row.IsExtraInfo = true;
+		QueueRow(row);
 	}
 }
 
@@ -272,9 +497,9 @@ void TraceLogger::WriteDisassembly(DisassemblyInfo &info, RowPart &rowPart, uint
 	WriteValue(output, code, rowPart);
 }
 
-void TraceLogger::WriteEffectiveAddress(DisassemblyInfo &info, RowPart &rowPart, void *cpuState, string &output, SnesMemoryType cpuMemoryType, CpuType cpuType)
+void TraceLogger::WriteEffectiveAddress(TraceLogRow &row, RowPart &rowPart, string &output, SnesMemoryType cpuMemoryType)
 {
-	int32_t effectiveAddress = info.GetEffectiveAddress(_console, cpuState, cpuType);
+	int32_t effectiveAddress = row.EffectiveAddress;
 	if(effectiveAddress >= 0) {
 		if(_options.UseLabels) {
 			AddressInfo addr { effectiveAddress, cpuMemoryType };
@@ -288,18 +513,15 @@ void TraceLogger::WriteEffectiveAddress(DisassemblyInfo &info, RowPart &rowPart,
 	}
 }
 
-void TraceLogger::WriteMemoryValue(DisassemblyInfo &info, RowPart &rowPart, void *cpuState, string &output, SnesMemoryType memType, CpuType cpuType)
+void TraceLogger::WriteMemoryValue(TraceLogRow &row, RowPart &rowPart, string &output)
 {
-	int32_t address = info.GetEffectiveAddress(_console, cpuState, cpuType);
-	if(address >= 0) {
-		uint8_t valueSize;
-		uint16_t value = info.GetMemoryValue(address, _memoryDumper, memType, valueSize);
+	if(row.EffectiveAddress >= 0) {
 		if(rowPart.DisplayInHex) {
 			output += "= $";
-			if(valueSize == 2) {
-				WriteValue(output, (uint16_t)value, rowPart);
+			if(row.MemoryValueSize == 2) {
+				WriteValue(output, (uint16_t)row.MemoryValue, rowPart);
 			} else {
-				WriteValue(output, (uint8_t)value, rowPart);
+				WriteValue(output, (uint8_t)row.MemoryValue, rowPart);
 			}
 		} else {
 			output += "= ";
@@ -314,8 +536,9 @@ void TraceLogger::WriteAlign(int originalSize, RowPart &rowPart, string &output)
 	}
 }
 
-void TraceLogger::GetTraceRow(string &output, CpuState &cpuState, PpuState &ppuState, DisassemblyInfo &disassemblyInfo, SnesMemoryType memType, CpuType cpuType)
+void TraceLogger::GetTraceRow(string &output, CpuState &cpuState, TraceLogRow &row, SnesMemoryType memType)
 {
+	DisassemblyInfo &disassemblyInfo = row.Disassembly;
 	int originalSize = (int)output.size();
 	uint32_t pcAddress = (cpuState.K << 16) | cpuState.PC;
 	for(RowPart& rowPart : _rowParts) {
@@ -323,8 +546,8 @@ void TraceLogger::GetTraceRow(string &output, CpuState &cpuState, PpuState &ppuS
 			case RowDataType::Text: output += rowPart.Text; break;
 			case RowDataType::ByteCode: WriteByteCode(disassemblyInfo, rowPart, output); break;
 			case RowDataType::Disassembly: WriteDisassembly(disassemblyInfo, rowPart, (uint8_t)cpuState.SP, pcAddress, output); break;
-			case RowDataType::EffectiveAddress: WriteEffectiveAddress(disassemblyInfo, rowPart, &cpuState, output, memType, cpuType); break;
-			case RowDataType::MemoryValue: WriteMemoryValue(disassemblyInfo, rowPart, &cpuState, output, memType, cpuType); break;
+			case RowDataType::EffectiveAddress: WriteEffectiveAddress(row, rowPart, output, memType); break;
+			case RowDataType::MemoryValue: WriteMemoryValue(row, rowPart, output); break;
 			case RowDataType::Align: WriteAlign(originalSize, rowPart, output); break;
 
 			case RowDataType::PC: WriteValue(output, HexUtilities::ToHex24(pcAddress), rowPart); break;
@@ -335,10 +558,10 @@ void TraceLogger::GetTraceRow(string &output, CpuState &cpuState, PpuState &ppuS
 			case RowDataType::DB: WriteValue(output, cpuState.DBR, rowPart); break;
 			case RowDataType::SP: WriteValue(output, cpuState.SP, rowPart); break;
 			case RowDataType::PS: GetStatusFlag<CpuType::Cpu>(output, cpuState.PS, rowPart); break;
-			case RowDataType::Cycle: WriteValue(output, ppuState.Cycle, rowPart); break;
-			case RowDataType::Scanline: WriteValue(output, ppuState.Scanline, rowPart); break;
-			case RowDataType::HClock: WriteValue(output, ppuState.HClock, rowPart); break;
-			case RowDataType::FrameCount: WriteValue(output, ppuState.FrameCount, rowPart); break;
+			case RowDataType::Cycle: WriteValue(output, row.Cycle, rowPart); break;
+			case RowDataType::Scanline: WriteValue(output, row.Scanline, rowPart); break;
+			case RowDataType::HClock: WriteValue(output, row.HClock, rowPart); break;
+			case RowDataType::FrameCount: WriteValue(output, row.FrameCount, rowPart); break;
 			case RowDataType::CycleCount: WriteValue(output, (uint32_t)cpuState.CycleCount, rowPart); break;
 			default: break;
 		}
@@ -346,8 +569,9 @@ void TraceLogger::GetTraceRow(string &output, CpuState &cpuState, PpuState &ppuS
 	output += _options.UseWindowsEol ? "\r\n" : "\n";
 }
 
-void TraceLogger::GetTraceRow(string &output, SpcState &cpuState, PpuState &ppuState, DisassemblyInfo &disassemblyInfo)
+void TraceLogger::GetTraceRow(string &output, SpcState &cpuState, TraceLogRow &row)
 {
+	DisassemblyInfo &disassemblyInfo = row.Disassembly;
 	int originalSize = (int)output.size();
 	uint32_t pcAddress = cpuState.PC;
 	for(RowPart& rowPart : _spcRowParts) {
@@ -355,8 +579,8 @@ void TraceLogger::GetTraceRow(string &output, SpcState &cpuState, PpuState &ppuS
 			case RowDataType::Text: output += rowPart.Text; break;
 			case RowDataType::ByteCode: WriteByteCode(disassemblyInfo, rowPart, output); break;
 			case RowDataType::Disassembly: WriteDisassembly(disassemblyInfo, rowPart, cpuState.SP, pcAddress, output); break;
-			case RowDataType::EffectiveAddress: WriteEffectiveAddress(disassemblyInfo, rowPart, &cpuState, output, SnesMemoryType::SpcMemory, CpuType::Spc); break;
-			case RowDataType::MemoryValue: WriteMemoryValue(disassemblyInfo, rowPart, &cpuState, output, SnesMemoryType::SpcMemory, CpuType::Spc); break;
+			case RowDataType::EffectiveAddress: WriteEffectiveAddress(row, rowPart, output, SnesMemoryType::SpcMemory); break;
+			case RowDataType::MemoryValue: WriteMemoryValue(row, rowPart, output); break;
 			case RowDataType::Align: WriteAlign(originalSize, rowPart, output); break;
 
 			case RowDataType::PC: WriteValue(output, HexUtilities::ToHex((uint16_t)pcAddress), rowPart); break;
@@ -365,10 +589,10 @@ void TraceLogger::GetTraceRow(string &output, SpcState &cpuState, PpuState &ppuS
 			case RowDataType::Y: WriteValue(output, cpuState.Y, rowPart); break;
 			case RowDataType::SP: WriteValue(output, cpuState.SP, rowPart); break;
 			case RowDataType::PS: GetStatusFlag<CpuType::Spc>(output, cpuState.PS, rowPart); break;
-			case RowDataType::Cycle: WriteValue(output, ppuState.Cycle, rowPart); break;
-			case RowDataType::Scanline: WriteValue(output, ppuState.Scanline, rowPart); break;
-			case RowDataType::HClock: WriteValue(output, ppuState.HClock, rowPart); break;
-			case RowDataType::FrameCount: WriteValue(output, ppuState.FrameCount, rowPart); break;
+			case RowDataType::Cycle: WriteValue(output, row.Cycle, rowPart); break;
+			case RowDataType::Scanline: WriteValue(output, row.Scanline, rowPart); break;
+			case RowDataType::HClock: WriteValue(output, row.HClock, rowPart); break;
+			case RowDataType::FrameCount: WriteValue(output, row.FrameCount, rowPart); break;
 
 			default: break;
 		}
@@ -376,8 +600,9 @@ void TraceLogger::GetTraceRow(string &output, SpcState &cpuState, PpuState &ppuS
 	output += _options.UseWindowsEol ? "\r\n" : "\n";
 }
 
-void TraceLogger::GetTraceRow(string &output, NecDspState &cpuState, PpuState &ppuState, DisassemblyInfo &disassemblyInfo)
+void TraceLogger::GetTraceRow(string &output, NecDspState &cpuState, TraceLogRow &row)
 {
+	DisassemblyInfo &disassemblyInfo = row.Disassembly;
 	int originalSize = (int)output.size();
 	uint32_t pcAddress = cpuState.PC;
 	for(RowPart& rowPart : _dspRowParts) {
@@ -406,18 +631,19 @@ void TraceLogger::GetTraceRow(string &output, NecDspState &cpuState, PpuState &p
 				WriteValue(output, cpuState.A, rowPart); 
 				break;
 			case RowDataType::SP: WriteValue(output, cpuState.SP, rowPart); break;
-			case RowDataType::Cycle: WriteValue(output, ppuState.Cycle, rowPart); break;
-			case RowDataType::Scanline: WriteValue(output, ppuState.Scanline, rowPart); break;
-			case RowDataType::HClock: WriteValue(output, ppuState.HClock, rowPart); break;
-			case RowDataType::FrameCount: WriteValue(output, ppuState.FrameCount, rowPart); break;
+			case RowDataType::Cycle: WriteValue(output, row.Cycle, rowPart); break;
+			case RowDataType::Scanline: WriteValue(output, row.Scanline, rowPart); break;
+			case RowDataType::HClock: WriteValue(output, row.HClock, rowPart); break;
+			case RowDataType::FrameCount: WriteValue(output, row.FrameCount, rowPart); break;
 			default: break;
 		}
 	}
 	output += _options.UseWindowsEol ? "\r\n" : "\n";
 }
 
-void TraceLogger::GetTraceRow(string &output, GsuState &gsuState, PpuState &ppuState, DisassemblyInfo &disassemblyInfo)
+void TraceLogger::GetTraceRow(string &output, GsuState &gsuState, TraceLogRow &row)
 {
+	DisassemblyInfo &disassemblyInfo = row.Disassembly;
 	int originalSize = (int)output.size();
 	uint32_t pcAddress = (gsuState.ProgramBank << 16) | gsuState.R[15];
 	for(RowPart& rowPart : _gsuRowParts) {
@@ -437,10 +663,10 @@ void TraceLogger::GetTraceRow(string &output, GsuState &gsuState, PpuState &ppuS
 			case RowDataType::X: WriteValue(output, gsuState.SrcReg, rowPart); break;
 			case RowDataType::Y: WriteValue(output, gsuState.DestReg, rowPart); break;
 
-			case RowDataType::Cycle: WriteValue(output, ppuState.Cycle, rowPart); break;
-			case RowDataType::Scanline: WriteValue(output, ppuState.Scanline, rowPart); break;
-			case RowDataType::HClock: WriteValue(output, ppuState.HClock, rowPart); break;
-			case RowDataType::FrameCount: WriteValue(output, ppuState.FrameCount, rowPart); break;
+			case RowDataType::Cycle: WriteValue(output, row.Cycle, rowPart); break;
+			case RowDataType::Scanline: WriteValue(output, row.Scanline, rowPart); break;
+			case RowDataType::HClock: WriteValue(output, row.HClock, rowPart); break;
+			case RowDataType::FrameCount: WriteValue(output, row.FrameCount, rowPart); break;
 			default: break;
 		}
 	}
@@ -448,8 +674,9 @@ void TraceLogger::GetTraceRow(string &output, GsuState &gsuState, PpuState &ppuS
 }
 
 
-void TraceLogger::GetTraceRow(string &output, Cx4State &cx4State, PpuState &ppuState, DisassemblyInfo &disassemblyInfo)
+void TraceLogger::GetTraceRow(string &output, Cx4State &cx4State, TraceLogRow &row)
 {
+	DisassemblyInfo &disassemblyInfo = row.Disassembly;
 	int originalSize = (int)output.size();
 	uint32_t pcAddress = (cx4State.Cache.Address[cx4State.Cache.Page] + (cx4State.PC * 2)) & 0xFFFFFF;
 	for(RowPart& rowPart : _cx4RowParts) {
@@ -475,18 +702,19 @@ void TraceLogger::GetTraceRow(string &output, Cx4State &cx4State, PpuState &ppuS
 				}
 				break;
 
-			case RowDataType::Cycle: WriteValue(output, ppuState.Cycle, rowPart); break;
-			case RowDataType::Scanline: WriteValue(output, ppuState.Scanline, rowPart); break;
-			case RowDataType::HClock: WriteValue(output, ppuState.HClock, rowPart); break;
-			case RowDataType::FrameCount: WriteValue(output, ppuState.FrameCount, rowPart); break;
+			case RowDataType::Cycle: WriteValue(output, row.Cycle, rowPart); break;
+			case RowDataType::Scanline: WriteValue(output, row.Scanline, rowPart); break;
+			case RowDataType::HClock: WriteValue(output, row.HClock, rowPart); break;
+			case RowDataType::FrameCount: WriteValue(output, row.FrameCount, rowPart); break;
 			default: break;
 		}
 	}
 	output += _options.UseWindowsEol ? "\r\n" : "\n";
 }
 
-void TraceLogger::GetTraceRow(string& output, GbCpuState& cpuState, GbPpuState& ppuState, DisassemblyInfo& disassemblyInfo)
+void TraceLogger::GetTraceRow(string& output, GbCpuState& cpuState, TraceLogRow& row)
 {
+	DisassemblyInfo& disassemblyInfo = row.Disassembly;
 	int originalSize = (int)output.size();
 	uint32_t pcAddress = cpuState.PC;
 	for(RowPart& rowPart : _gbRowParts) {
@@ -494,8 +722,8 @@ void TraceLogger::GetTraceRow(string& output, GbCpuState& cpuState, GbPpuState&
 			case RowDataType::Text: output += rowPart.Text; break;
 			case RowDataType::ByteCode: WriteByteCode(disassemblyInfo, rowPart, output); break;
 			case RowDataType::Disassembly: WriteDisassembly(disassemblyInfo, rowPart, (uint8_t)cpuState.SP, pcAddress, output); break;
-			case RowDataType::EffectiveAddress: WriteEffectiveAddress(disassemblyInfo, rowPart, &cpuState, output, SnesMemoryType::GameboyMemory, CpuType::Gameboy); break;
-			case RowDataType::MemoryValue: WriteMemoryValue(disassemblyInfo, rowPart, &cpuState, output, SnesMemoryType::GameboyMemory, CpuType::Gameboy); break;
+			case RowDataType::EffectiveAddress: WriteEffectiveAddress(row, rowPart, output, SnesMemoryType::GameboyMemory); break;
+			case RowDataType::MemoryValue: WriteMemoryValue(row, rowPart, output); break;
 			case RowDataType::Align: WriteAlign(originalSize, rowPart, output); break;
 
 			case RowDataType::PC: WriteValue(output, HexUtilities::ToHex((uint16_t)pcAddress), rowPart); break;
@@ -508,9 +736,9 @@ void TraceLogger::GetTraceRow(string& output, GbCpuState& cpuState, GbPpuState&
 			case RowDataType::H: WriteValue(output, cpuState.H, rowPart); break;
 			case RowDataType::L: WriteValue(output, cpuState.L, rowPart); break;
 			case RowDataType::SP: WriteValue(output, cpuState.SP, rowPart); break;
-			case RowDataType::Cycle: WriteValue(output, ppuState.Cycle, rowPart); break;
-			case RowDataType::Scanline: WriteValue(output, ppuState.Scanline, rowPart); break;
-			case RowDataType::FrameCount: WriteValue(output, ppuState.FrameCount, rowPart); break;
+			case RowDataType::Cycle: WriteValue(output, row.Cycle, rowPart); break;
+			case RowDataType::Scanline: WriteValue(output, (uint8_t)row.Scanline, rowPart); break;
+			case RowDataType::FrameCount: WriteValue(output, row.FrameCount, rowPart); break;
 
 			default: break;
 		}
@@ -537,24 +765,89 @@ bool TraceLogger::ConditionMatches(DebugState &state, DisassemblyInfo &disassemb
 }
 */
 
-void TraceLogger::GetTraceRow(string &output, CpuType cpuType, DisassemblyInfo &disassemblyInfo, DebugState &state)
+void TraceLogger::GetTraceRow(string &output, TraceLogRow &row)
 {
+	if(row.EffectiveAddress == TraceLogger::AddressNotCaptured && _logEffectiveAddress[(int)row.Type]) {
+		//Rows that are only displayed on screen are captured when they are formatted, like the rest of the row
+		CaptureMemoryOperand(row, _logMemoryValue[(int)row.Type]);
+	}
+
+	switch(row.Type) {
+		case CpuType::Cpu: GetTraceRow(output, row.State.Cpu, row, SnesMemoryType::CpuMemory); break;
+		case CpuType::Spc: GetTraceRow(output, row.State.Spc, row); break;
+		case CpuType::NecDsp: GetTraceRow(output, row.State.NecDsp, row); break;
+		case CpuType::Sa1: GetTraceRow(output, row.State.Cpu, row, SnesMemoryType::Sa1Memory); break;
+		case CpuType::Gsu: GetTraceRow(output, row.State.Gsu, row); break;
+		case CpuType::Cx4: GetTraceRow(output, row.State.Cx4, row); break;
+		case CpuType::Gameboy: GetTraceRow(output, row.State.Gameboy, row); break;
+	}
+}
+
+void TraceLogger::InitRow(TraceLogRow &row, CpuType cpuType, DisassemblyInfo &disassemblyInfo, DebugState &state)
+{
+	//Rows are written as-is to binary logs, clear the padding bytes to keep the files deterministic
+	memset((void*)&row, 0, sizeof(row));
+
+	row.Type = cpuType;
+	row.IsExtraInfo = false;
+	row.Disassembly = disassemblyInfo;
+
 	switch(cpuType) {
-		case CpuType::Cpu: GetTraceRow(output, state.Cpu, state.Ppu, disassemblyInfo, SnesMemoryType::CpuMemory, cpuType); break;
-		case CpuType::Spc: GetTraceRow(output, state.Spc, state.Ppu, disassemblyInfo); break;
-		case CpuType::NecDsp: GetTraceRow(output, state.NecDsp, state.Ppu, disassemblyInfo); break;
-		case CpuType::Sa1: GetTraceRow(output, state.Sa1.Cpu, state.Ppu, disassemblyInfo, SnesMemoryType::Sa1Memory, cpuType); break;
-		case CpuType::Gsu: GetTraceRow(output, state.Gsu, state.Ppu, disassemblyInfo); break;
-		case CpuType::Cx4: GetTraceRow(output, state.Cx4, state.Ppu, disassemblyInfo); break;
-		case CpuType::Gameboy: GetTraceRow(output, state.Gameboy.Cpu, state.Gameboy.Ppu, disassemblyInfo); break;
+		case CpuType::Cpu: row.State.Cpu = state.Cpu; break;
+		case CpuType::Spc: row.State.Spc = state.Spc; break;
+		case CpuType::NecDsp: row.State.NecDsp = state.NecDsp; break;
+		case CpuType::Sa1: row.State.Cpu = state.Sa1.Cpu; break;
+		case CpuType::Gsu: row.State.Gsu = state.Gsu; break;
+		case CpuType::Cx4: row.State.Cx4 = state.Cx4; break;
+		case CpuType::Gameboy: row.State.Gameboy = state.Gameboy.Cpu; break;
+	}
+
+	if(cpuType == CpuType::Gameboy) {
+		row.Cycle = state.Gameboy.Ppu.Cycle;
+		row.Scanline = state.Gameboy.Ppu.Scanline;
+		row.HClock = 0;
+		row.FrameCount = state.Gameboy.Ppu.FrameCount;
+	} else {
+		row.Cycle = state.Ppu.Cycle;
+		row.Scanline = state.Ppu.Scanline;
+		row.HClock = state.Ppu.HClock;
+		row.FrameCount = state.Ppu.FrameCount;
+	}
+
+	//Rows logged to a file are formatted later by the writer thread (or by ConvertBinaryLog), after memory may have changed
+	//Rows that are only displayed on screen skip this, the trace logger window formats them on demand
+	row.EffectiveAddress = TraceLogger::AddressNotCaptured;
+	if(_logToFile && (_binaryLog || _logEffectiveAddress[(int)cpuType])) {
+		CaptureMemoryOperand(row, _binaryLog || _logMemoryValue[(int)cpuType]);
+	}
+}
+
+void TraceLogger::CaptureMemoryOperand(TraceLogRow &row, bool captureValue)
+{
+	void* cpuState = nullptr;
+	SnesMemoryType memType = SnesMemoryType::CpuMemory;
+	switch(row.Type) {
+		case CpuType::Cpu: cpuState = &row.State.Cpu; break;
+		case CpuType::Spc: cpuState = &row.State.Spc; memType = SnesMemoryType::SpcMemory; break;
+		case CpuType::NecDsp: cpuState = &row.State.NecDsp; break;
+		case CpuType::Sa1: cpuState = &row.State.Cpu; memType = SnesMemoryType::Sa1Memory; break;
+		case CpuType::Gsu: cpuState = &row.State.Gsu; break;
+		case CpuType::Cx4: cpuState = &row.State.Cx4; break;
+		case CpuType::Gameboy: cpuState = &row.State.Gameboy; memType = SnesMemoryType::GameboyMemory; break;
+	}
+
+	row.MemoryValue = 0;
+	row.MemoryValueSize = 0;
+	row.EffectiveAddress = row.Disassembly.GetEffectiveAddress(_console, cpuState, row.Type);
+	if(row.EffectiveAddress >= 0 && captureValue) {
+		row.MemoryValue = row.Disassembly.GetMemoryValue(row.EffectiveAddress, _memoryDumper, memType, row.MemoryValueSize);
 	}
 }
 
 void TraceLogger::AddRow(CpuType cpuType, DisassemblyInfo &disassemblyInfo, DebugState &state)
 {
-	_logCpuType[_currentPos] = cpuType;
-	_disassemblyCache[_currentPos] = disassemblyInfo;
-	_stateCache[_currentPos] = state;
+	TraceLogRow &row = _rowCache[_currentPos];
+	InitRow(row, cpuType, disassemblyInfo, state);
 	_pendingLog = false;
 
 	if(_logCount < ExecutionLogSize) {
@@ -562,11 +855,7 @@ void TraceLogger::AddRow(CpuType cpuType, DisassemblyInfo &disassemblyInfo, Debu
 	}
 
 	if(_logToFile) {
-		GetTraceRow(_outputBuffer, cpuType, _disassemblyCache[_currentPos], _stateCache[_currentPos]);
-		if(_outputBuffer.size() > 32768) {
-			_outputFile << _outputBuffer;
-			_outputBuffer.clear();
-		}
+		QueueRow(row);
 	}
 
 	_currentPos = (_currentPos + 1) % ExecutionLogSize;
@@ -606,9 +895,7 @@ const char* TraceLogger::GetExecutionTrace(uint32_t lineCount)
 	{
 		auto lock = _lock.AcquireSafe();
 		lineCount = std::min(lineCount, _logCount);
-		memcpy(_stateCacheCopy, _stateCache, sizeof(DebugState) * TraceLogger::ExecutionLogSize);
-		memcpy(_disassemblyCacheCopy, _disassemblyCache, sizeof(DisassemblyInfo) * TraceLogger::ExecutionLogSize);
-		memcpy(_logCpuTypeCopy, _logCpuType, sizeof(CpuType) * TraceLogger::ExecutionLogSize);
+		std::copy(_rowCache, _rowCache + TraceLogger::ExecutionLogSize, _rowCacheCopy);
 		startPos = (_currentPos > 0 ? _currentPos : TraceLogger::ExecutionLogSize) - 1;
 	}
 
@@ -618,38 +905,39 @@ const char* TraceLogger::GetExecutionTrace(uint32_t lineCount)
 	}
 
 	if(enabled && lineCount > 0) {
+		auto formatLock = _formatLock.AcquireSafe();
 		for(int i = 0; i < TraceLogger::ExecutionLogSize; i++) {
 			int index = (startPos - i);
 			if(index < 0) {
 				index = TraceLogger::ExecutionLogSize + index;
 			}
 
-			if((i > 0 && startPos == index) || !_disassemblyCacheCopy[index].IsInitialized()) {
+			TraceLogRow &row = _rowCacheCopy[index];
+			if((i > 0 && startPos == index) || !row.Disassembly.IsInitialized()) {
 				//If the entire array was checked, or this element is not initialized, stop
 				break;
 			}
 
-			CpuType cpuType = _logCpuTypeCopy[index];
+			CpuType cpuType = row.Type;
 			if(!_logCpu[(int)cpuType]) {
 				//This line isn't for a CPU currently being logged
 				continue;
 			}
 
-			DebugState &state = _stateCacheCopy[index];
 			switch(cpuType) {
-				case CpuType::Cpu: _executionTrace += "\x2\x1" + HexUtilities::ToHex24((state.Cpu.K << 16) | state.Cpu.PC) + "\x1"; break;
-				case CpuType::Spc: _executionTrace += "\x3\x1" + HexUtilities::ToHex(state.Spc.PC) + "\x1"; break;
-				case CpuType::NecDsp: _executionTrace += "\x4\x1" + HexUtilities::ToHex(state.NecDsp.PC) + "\x1"; break;
-				case CpuType::Sa1: _executionTrace += "\x4\x1" + HexUtilities::ToHex24((state.Sa1.Cpu.K << 16) | state.Sa1.Cpu.PC) + "\x1"; break;
-				case CpuType::Gsu: _executionTrace += "\x4\x1" + HexUtilities::ToHex24((state.Gsu.ProgramBank << 16) | state.Gsu.R[15]) + "\x1"; break;
-				case CpuType::Cx4: _executionTrace += "\x4\x1" + HexUtilities::ToHex24((state.Cx4.Cache.Address[state.Cx4.Cache.Page] + (state.Cx4.PC * 2)) & 0xFFFFFF) + "\x1"; break;
-				case CpuType::Gameboy: _executionTrace += "\x4\x1" + HexUtilities::ToHex(state.Gameboy.Cpu.PC) + "\x1"; break;
+				case CpuType::Cpu: _executionTrace += "\x2\x1" + HexUtilities::ToHex24((row.State.Cpu.K << 16) | row.State.Cpu.PC) + "\x1"; break;
+				case CpuType::Spc: _executionTrace += "\x3\x1" + HexUtilities::ToHex(row.State.Spc.PC) + "\x1"; break;
+				case CpuType::NecDsp: _executionTrace += "\x4\x1" + HexUtilities::ToHex(row.State.NecDsp.PC) + "\x1"; break;
+				case CpuType::Sa1: _executionTrace += "\x4\x1" + HexUtilities::ToHex24((row.State.Cpu.K << 16) | row.State.Cpu.PC) + "\x1"; break;
+				case CpuType::Gsu: _executionTrace += "\x4\x1" + HexUtilities::ToHex24((row.State.Gsu.ProgramBank << 16) | row.State.Gsu.R[15]) + "\x1"; break;
+				case CpuType::Cx4: _executionTrace += "\x4\x1" + HexUtilities::ToHex24((row.State.Cx4.Cache.Address[row.State.Cx4.Cache.Page] + (row.State.Cx4.PC * 2)) & 0xFFFFFF) + "\x1"; break;
+				case CpuType::Gameboy: _executionTrace += "\x4\x1" + HexUtilities::ToHex(row.State.Gameboy.PC) + "\x1"; break;
 			}
 
 			string byteCode;
-			_disassemblyCacheCopy[index].GetByteCode(byteCode);
+			row.Disassembly.GetByteCode(byteCode);
 			_executionTrace += byteCode + "\x1";
-			GetTraceRow(_executionTrace, cpuType, _disassemblyCacheCopy[index], _stateCacheCopy[index]);
+			GetTraceRow(_executionTrace, row);
 
 			lineCount--;
 			if(lineCount == 0) {
@@ -8,6 +8,8 @@
 #include "DisassemblyInfo.h"
 #include "DebugUtilities.h"
 #include "../Utilities/SimpleLock.h"
+#include "../Utilities/AutoResetEvent.h"
+#include "../Utilities/SpscRingBuffer.h"
 
 class Console;
 class Debugger;
@@ -73,10 +75,55 @@ struct RowPart
 	int MinWidth;
 };
 
+union TraceLogCpuState
+{
+	CpuState Cpu; //Also used for the SA-1
+	SpcState Spc;
+	NecDspState NecDsp;
+	GsuState Gsu;
+	Cx4State Cx4;
+	GbCpuState Gameboy;
+
+	TraceLogCpuState() {}
+};
+
+//Everything needed to format a trace log row for one instruction (the state of the CPU that ran it, and the PPU's position)
+struct TraceLogRow
+{
+	CpuType Type;
+	bool IsExtraInfo;
+	DisassemblyInfo Disassembly;
+	TraceLogCpuState State;
+
+	uint16_t Cycle;
+	uint16_t Scanline;
+	uint16_t HClock;
+	uint32_t FrameCount;
+
+	//Captured when the row is logged to a file (AddressNotCaptured otherwise), because memory may have changed by the time the writer thread formats the row
+	int32_t EffectiveAddress;
+	uint16_t MemoryValue;
+	uint8_t MemoryValueSize;
+};
+
+//Binary trace logs are a header followed by raw TraceLogRow records, which only contain the state of the CPU that ran the instruction
+//Extra info rows are followed by their text's length and the text itself
+//They can only be converted to text by a build with the same TraceLogRow layout
+struct TraceLogFileHeader
+{
+	char Magic[4];
+	uint32_t Version;
+	uint32_t RowSize;
+};
+
 class TraceLogger
 {
 private:
 	static constexpr int ExecutionLogSize = 30000;
+	static constexpr int WriteQueueSize = 16384;
+	static constexpr int WriteBatchSize = 256;
+	static constexpr uint32_t BinaryLogVersion = 1;
+	static constexpr int32_t AddressNotCaptured = -2;
 
 	//Must be static to be thread-safe when switching game
 	static string _executionTrace;
@@ -98,43 +145,63 @@ private:
 	vector<RowPart> _gbRowParts;
 
 	bool _logCpu[(int)DebugUtilities::GetLastCpuType() + 1] = {};
+	bool _logEffectiveAddress[(int)DebugUtilities::GetLastCpuType() + 1] = {};
+	bool _logMemoryValue[(int)DebugUtilities::GetLastCpuType() + 1] = {};
 
 	bool _pendingLog;
 	//CpuState _lastState;
 	//DisassemblyInfo _lastDisassemblyInfo;
 
 	bool _logToFile;
+	bool _binaryLog;
 	uint32_t _currentPos;
 	uint32_t _logCount;
-	DebugState *_stateCache = nullptr;
-	DisassemblyInfo *_disassemblyCache = nullptr;
-	CpuType* _logCpuType = nullptr;
-
-	DebugState *_stateCacheCopy = nullptr;
-	DisassemblyInfo *_disassemblyCacheCopy = nullptr;
-	CpuType* _logCpuTypeCopy = nullptr;
+	TraceLogRow *_rowCache = nullptr;
+	TraceLogRow *_rowCacheCopy = nullptr;
 
 	SimpleLock _lock;
 
+	//Protects the options and row formats while rows are being formatted
+	SimpleLock _formatLock;
+
+	//Rows logged to the file are formatted and written by the writer thread
+	SpscRingBuffer<TraceLogRow> _writeQueue;
+	std::thread _writerThread;
+	atomic<bool> _stopWriter;
+	AutoResetEvent _writerSignal;
+
+	SimpleLock _extraInfoLock;
+	deque<string> _extraInfo;
+
+	void WriterThread(bool binaryFormat);
+	uint32_t GetBinaryStateSize(TraceLogRow &row);
+	void WriteBinaryRow(TraceLogRow &row);
+	bool ReadBinaryRow(ifstream &input, TraceLogRow &row, string &extraInfo);
+	void CaptureMemoryOperand(TraceLogRow &row, bool captureValue);
+	void WriteExtraInfo(string &output, string &extraInfo);
+	void QueueRow(TraceLogRow &row);
+	void InitRow(TraceLogRow &row, CpuType cpuType, DisassemblyInfo &disassemblyInfo, DebugState &state);
+	bool HasRowPart(vector<RowPart> &rowParts, RowDataType dataType);
+
 	template<CpuType cpuType> void GetStatusFlag(string &output, uint8_t ps, RowPart& part);
 
 	void WriteByteCode(DisassemblyInfo &info, RowPart &rowPart, string &output);
 	void WriteDisassembly(DisassemblyInfo &info, RowPart &rowPart, uint8_t sp, uint32_t pc, string &output);
-	void WriteEffectiveAddress(DisassemblyInfo &info, RowPart &rowPart, void *cpuState, string &output, SnesMemoryType cpuMemoryType, CpuType cpuType);
-	void WriteMemoryValue(DisassemblyInfo &info, RowPart &rowPart, void *cpuState, string &output, SnesMemoryType memType, CpuType cpuType);
+	void WriteEffectiveAddress(TraceLogRow &row, RowPart &rowPart, string &output, SnesMemoryType cpuMemoryType);
+	void WriteMemoryValue(TraceLogRow &row, RowPart &rowPart, string &output);
 	void WriteAlign(int originalSize, RowPart &rowPart, string &output);
 	void AddRow(CpuType cpuType, DisassemblyInfo &disassemblyInfo, DebugState &state);
 	//bool ConditionMatches(DebugState &state, DisassemblyInfo &disassemblyInfo, OperationInfo &operationInfo);
 	
 	void ParseFormatString(vector<RowPart> &rowParts, string format);
 
-	void GetTraceRow(string &output, CpuType cpuType, DisassemblyInfo &disassemblyInfo, DebugState &state);
-	void GetTraceRow(string &output, CpuState &cpuState, PpuState &ppuState, DisassemblyInfo &disassemblyInfo, SnesMemoryType memType, CpuType cpuType);
-	void GetTraceRow(string &output, SpcState &cpuState, PpuState &ppuState, DisassemblyInfo &disassemblyInfo);
-	void GetTraceRow(string &output, NecDspState &cpuState, PpuState &ppuState, DisassemblyInfo &disassemblyInfo);
-	void GetTraceRow(string &output, GsuState &gsuState, PpuState &ppuState, DisassemblyInfo &disassemblyInfo);
-	void GetTraceRow(string& output, Cx4State& cx4State, PpuState& ppuState, DisassemblyInfo& disassemblyInfo);
-	void GetTraceRow(string &output, GbCpuState &gbState, GbPpuState &gbPpuState, DisassemblyInfo &disassemblyInfo);
+	void GetTraceRow(string &output, TraceLogRow &row);
+	void GetTraceRow(string &output, CpuState &cpuState, TraceLogRow &row, SnesMemoryType memType);
+	void GetTraceRow(string &output, SpcState &cpuState, TraceLogRow &row);
+	void GetTraceRow(string &output, NecDspState &cpuState, TraceLogRow &row);
+	void GetTraceRow(string &output, GsuState &gsuState, TraceLogRow &row);
+	void GetTraceRow(string& output, Cx4State& cx4State, TraceLogRow& row);
+	void GetTraceRow(string &output, GbCpuState &gbState, TraceLogRow &row);
 
 	template<typename T> void WriteValue(string &output, T value, RowPart& rowPart);
 
@@ -148,8 +215,9 @@ public:
 	void Clear();
 	//void LogNonExec(OperationInfo& operationInfo);
 	void SetOptions(TraceLoggerOptions options);
-	void StartLogging(string filename);
+	void StartLogging(string filename, bool binaryFormat = false);
 	void StopLogging();
+	bool ConvertBinaryLog(string inputFile, string outputFile);
 
 	void LogExtraInfo(const char *log, uint32_t cycleCount);
 
@@ -17,7 +17,7 @@
 VideoDecoder::VideoDecoder(shared_ptr<Console> console)
 {
 	_console = console;
-	_frameChanged = false;
+	_readyIndex = 2;
 	_stopFlag = false;
 	_baseFrameInfo = { 512, 478 };
 	_lastFrameInfo = _baseFrameInfo;
@@ -110,22 +110,35 @@ void VideoDecoder::DecodeFrame(bool forRewind)
 
 	//Rewind manager will take care of sending the correct frame to the video renderer
 	_console->GetRewindManager()->SendFrame(outputBuffer, frameInfo.Width, frameInfo.Height, forRewind);
-
-	_frameChanged = false;
 }
 
 void VideoDecoder::DecodeThread()
 {
 	//This thread will decode the PPU's output (color ID to RGB, intensify r/g/b and produce a HD version of the frame if needed)
 	while(!_stopFlag.load()) {
-		//DecodeFrame returns the final ARGB frame we want to display in the emulator window
-		while(!_frameChanged) {
+		if(!(_readyIndex.load() & VideoDecoder::NewFrameFlag)) {
 			_waitForFrame.Wait();
-			if(_stopFlag.load()) {
-				return;
-			}
+			continue;
+		}
+
+		std::lock_guard<std::mutex> lock(_decodeLock);
+
+		//Swap the ready frame with the one that was decoded last (skips any older frame that was never decoded)
+		uint8_t readyIndex = _readyIndex.exchange(_readIndex);
+		_readIndex = readyIndex & ~VideoDecoder::NewFrameFlag;
+		_waitForPickup.Signal();
+		if(!(readyIndex & VideoDecoder::NewFrameFlag)) {
+			//Frame was discarded by UpdateFrameSync in the meantime
+			continue;
 		}
 
+		VideoDecoderFrame &frame = _frames[_readIndex];
+		_baseFrameInfo.Width = frame.Width;
+		_baseFrameInfo.Height = frame.Height;
+		_frameNumber = frame.FrameNumber;
+		_ppuOutputBuffer = frame.Buffer.data();
+
+		//DecodeFrame returns the final ARGB frame we want to display in the emulator window
 		DecodeFrame();
 	}
 }
@@ -141,15 +154,13 @@ void VideoDecoder::UpdateFrameSync(uint16_t *ppuOutputBuffer, uint16_t width, ui
 		return;
 	}
 
-	if(_frameChanged) {
-		//Last frame isn't done decoding yet - sometimes Signal() introduces a 25-30ms delay
-		while(_frameChanged) {
-			//Spin until decode is done
-		}
-		//At this point, we are sure that the decode thread is no longer busy
+	std::lock_guard<std::mutex> lock(_decodeLock);
+
+	//Discard any frame that hasn't been decoded yet, it is older than this one
+	uint8_t readyIndex = _readyIndex.load();
+	while((readyIndex & VideoDecoder::NewFrameFlag) && !_readyIndex.compare_exchange_weak(readyIndex, readyIndex & ~VideoDecoder::NewFrameFlag)) {
 	}
-	
-	_frameChanged = true;
+
 	_baseFrameInfo.Width = width;
 	_baseFrameInfo.Height = height;
 	_frameNumber = frameNumber;
@@ -164,19 +175,28 @@ void VideoDecoder::UpdateFrame(uint16_t *ppuOutputBuffer, uint16_t width, uint16
 		return;
 	}
 
-	if(_frameChanged) {
-		//Last frame isn't done decoding yet - sometimes Signal() introduces a 25-30ms delay
-		while(_frameChanged) {
-			//Spin until decode is done
+	//Copy the frame to the back buffer, and publish it as the most recent frame
+	VideoDecoderFrame &frame = _frames[_writeIndex];
+	uint32_t pixelCount = width * height;
+	if(frame.Buffer.size() < pixelCount) {
+		frame.Buffer.resize(pixelCount);
+	}
+	memcpy(frame.Buffer.data(), ppuOutputBuffer, pixelCount * sizeof(uint16_t));
+	frame.Width = width;
+	frame.Height = height;
+	frame.FrameNumber = frameNumber;
+
+	shared_ptr<VideoRenderer> videoRenderer = _console->GetVideoRenderer();
+	if(videoRenderer && videoRenderer->IsRecording()) {
+		//Recorders get their frames from the decode thread, so every frame must be decoded while recording:
+		//wait for the decode thread to pick up the previous frame instead of replacing it
+		while((_readyIndex.load() & VideoDecoder::NewFrameFlag) && _decodeThread && !_stopFlag.load()) {
+			_waitForPickup.Wait(10);
 		}
-		//At this point, we are sure that the decode thread is no longer busy
 	}
-	
-	_baseFrameInfo.Width = width;
-	_baseFrameInfo.Height = height;
-	_frameNumber = frameNumber;
-	_ppuOutputBuffer = ppuOutputBuffer;
-	_frameChanged = true;
+
+	//If the previous frame wasn't picked up by the decode thread yet, it gets dropped (and its buffer is reused)
+	_writeIndex = _readyIndex.exchange(_writeIndex | VideoDecoder::NewFrameFlag) & ~VideoDecoder::NewFrameFlag;
 	_waitForFrame.Signal();
 
 	_frameCount++;
@@ -187,8 +207,8 @@ void VideoDecoder::StartThread()
 #ifndef LIBRETRO
 	if(!_decodeThread) {	
 		_stopFlag = false;
-		_frameChanged = false;
 		_frameCount = 0;
+		_readyIndex = _readyIndex.load() & ~VideoDecoder::NewFrameFlag;
 		_waitForFrame.Reset();
 		
 		_decodeThread.reset(new thread(&VideoDecoder::DecodeThread, this));
@@ -2,6 +2,7 @@
 #include "stdafx.h"
 #include "../Utilities/SimpleLock.h"
 #include "../Utilities/AutoResetEvent.h"
+#include <mutex>
 #include "SettingTypes.h"
 
 class BaseVideoFilter;
@@ -11,9 +12,19 @@ class IRenderingDevice;
 class InputHud;
 class Console;
 
+struct VideoDecoderFrame
+{
+	vector<uint16_t> Buffer;
+	uint16_t Width;
+	uint16_t Height;
+	uint32_t FrameNumber;
+};
+
 class VideoDecoder
 {
 private:
+	static constexpr uint8_t NewFrameFlag = 0x80;
+
 	shared_ptr<Console> _console;
 
 	uint16_t *_ppuOutputBuffer = nullptr;
@@ -23,8 +34,19 @@ private:
 	unique_ptr<InputHud> _inputHud;
 
 	AutoResetEvent _waitForFrame;
-	
-	atomic<bool> _frameChanged;
+	AutoResetEvent _waitForPickup;
+
+	//Triple buffer used to send frames to the decode thread without blocking the emulation thread
+	//_writeIndex is only used by the emulation thread, _readIndex by the decode thread, and _readyIndex holds
+	//the most recent frame (with NewFrameFlag set until the decode thread picks it up)
+	VideoDecoderFrame _frames[3];
+	uint8_t _writeIndex = 0;
+	uint8_t _readIndex = 1;
+	atomic<uint8_t> _readyIndex;
+
+	//Prevents the decode thread and UpdateFrameSync from decoding a frame at the same time
+	std::mutex _decodeLock;
+
 	atomic<bool> _stopFlag;
 	uint32_t _frameCount = 0;
 
@@ -0,0 +1,271 @@
+#include "stdafx.h"
+#include "VideoFilterKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define VIDEO_KERNELS_X86
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define SSE2_FUNC
+		#define AVX2_FUNC
+	#else
+		#include <immintrin.h>
+		#define SSE2_FUNC __attribute__((target("sse2")))
+		#define AVX2_FUNC __attribute__((target("avx2")))
+	#endif
+#endif
+
+VideoFilterKernels::SimdLevel VideoFilterKernels::GetSimdLevel()
+{
+#ifdef VIDEO_KERNELS_X86
+	static SimdLevel level = []() {
+	#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		bool sse2 = (info[3] & (1 << 26)) != 0;
+		bool osAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x06) == 0x06;
+		bool avx2 = false;
+		if(osAvx && maxLeaf >= 7) {
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+	#else
+		__builtin_cpu_init();
+		bool sse2 = __builtin_cpu_supports("sse2");
+		bool avx2 = __builtin_cpu_supports("avx2");
+	#endif
+		return avx2 ? SimdLevel::Avx2 : (sse2 ? SimdLevel::Sse2 : SimdLevel::None);
+	}();
+	return level;
+#else
+	return SimdLevel::None;
+#endif
+}
+
+static __forceinline uint8_t To8Bit(uint8_t color)
+{
+	return (color << 3) + (color >> 2);
+}
+
+static __forceinline uint8_t ApplyIntensity(uint8_t color, uint8_t intensity)
+{
+	return color * intensity / 255;
+}
+
+#ifdef VIDEO_KERNELS_X86
+SSE2_FUNC static __forceinline __m128i ApplyIntensitySse2(__m128i color, __m128i intensity)
+{
+	//x * intensity / 255, for 16-bit values where x * intensity < 65536
+	__m128i t = _mm_mullo_epi16(color, intensity);
+	return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(t, _mm_set1_epi16(1)), _mm_srli_epi16(t, 8)), 8);
+}
+
+SSE2_FUNC static uint32_t ConvertRgb555ToArgbSse2(uint16_t* src, uint32_t* dst, uint32_t count, uint8_t scanlineIntensity)
+{
+	__m128i mask = _mm_set1_epi16(0x1F);
+	__m128i alpha = _mm_set1_epi16((short)0xFF00);
+	__m128i intensity = _mm_set1_epi16(scanlineIntensity);
+
+	uint32_t i = 0;
+	for(; i + 8 <= count; i += 8) {
+		__m128i rgb = _mm_loadu_si128((__m128i*)(src + i));
+		__m128i r = _mm_and_si128(rgb, mask);
+		__m128i g = _mm_and_si128(_mm_srli_epi16(rgb, 5), mask);
+		__m128i b = _mm_and_si128(_mm_srli_epi16(rgb, 10), mask);
+		r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+		g = _mm_or_si128(_mm_slli_epi16(g, 3), _mm_srli_epi16(g, 2));
+		b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+
+		if(scanlineIntensity < 255) {
+			r = ApplyIntensitySse2(r, intensity);
+			g = ApplyIntensitySse2(g, intensity);
+			b = ApplyIntensitySse2(b, intensity);
+		}
+
+		__m128i gb = _mm_or_si128(_mm_slli_epi16(g, 8), b);
+		__m128i ar = _mm_or_si128(r, alpha);
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi16(gb, ar));
+		_mm_storeu_si128((__m128i*)(dst + i + 4), _mm_unpackhi_epi16(gb, ar));
+	}
+	return i;
+}
+
+AVX2_FUNC static __forceinline __m256i ApplyIntensityAvx2(__m256i color, __m256i intensity)
+{
+	__m256i t = _mm256_mullo_epi16(color, intensity);
+	return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(t, _mm256_set1_epi16(1)), _mm256_srli_epi16(t, 8)), 8);
+}
+
+AVX2_FUNC static uint32_t ConvertRgb555ToArgbAvx2(uint16_t* src, uint32_t* dst, uint32_t count, uint8_t scanlineIntensity)
+{
+	__m256i mask = _mm256_set1_epi16(0x1F);
+	__m256i alpha = _mm256_set1_epi16((short)0xFF00);
+	__m256i intensity = _mm256_set1_epi16(scanlineIntensity);
+
+	uint32_t i = 0;
+	for(; i + 16 <= count; i += 16) {
+		__m256i rgb = _mm256_loadu_si256((__m256i*)(src + i));
+		__m256i r = _mm256_and_si256(rgb, mask);
+		__m256i g = _mm256_and_si256(_mm256_srli_epi16(rgb, 5), mask);
+		__m256i b = _mm256_and_si256(_mm256_srli_epi16(rgb, 10), mask);
+		r = _mm256_or_si256(_mm256_slli_epi16(r, 3), _mm256_srli_epi16(r, 2));
+		g = _mm256_or_si256(_mm256_slli_epi16(g, 3), _mm256_srli_epi16(g, 2));
+		b = _mm256_or_si256(_mm256_slli_epi16(b, 3), _mm256_srli_epi16(b, 2));
+
+		if(scanlineIntensity < 255) {
+			r = ApplyIntensityAvx2(r, intensity);
+			g = ApplyIntensityAvx2(g, intensity);
+			b = ApplyIntensityAvx2(b, intensity);
+		}
+
+		__m256i gb = _mm256_or_si256(_mm256_slli_epi16(g, 8), b);
+		__m256i ar = _mm256_or_si256(r, alpha);
+
+		//Unpack works within each 128-bit lane, reorder the lanes to get the pixels back in order
+		__m256i lo = _mm256_unpacklo_epi16(gb, ar);
+		__m256i hi = _mm256_unpackhi_epi16(gb, ar);
+		_mm256_storeu_si256((__m256i*)(dst + i), _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i*)(dst + i + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+	}
+	return i;
+}
+
+SSE2_FUNC static uint32_t ScaleRowSse2(uint32_t* src, uint32_t* dst, uint32_t count, uint32_t scale)
+{
+	uint32_t i = 0;
+	if(scale == 2) {
+		for(; i + 4 <= count; i += 4) {
+			__m128i pixels = _mm_loadu_si128((__m128i*)(src + i));
+			_mm_storeu_si128((__m128i*)(dst + i * 2), _mm_unpacklo_epi32(pixels, pixels));
+			_mm_storeu_si128((__m128i*)(dst + i * 2 + 4), _mm_unpackhi_epi32(pixels, pixels));
+		}
+	} else if(scale >= 4) {
+		for(; i < count; i++) {
+			__m128i pixel = _mm_set1_epi32((int)src[i]);
+			uint32_t* out = dst + i * scale;
+			uint32_t j = 0;
+			for(; j + 4 <= scale; j += 4) {
+				_mm_storeu_si128((__m128i*)(out + j), pixel);
+			}
+			for(; j < scale; j++) {
+				out[j] = src[i];
+			}
+		}
+	}
+	return i;
+}
+
+SSE2_FUNC static uint32_t ApplyScanlineIntensitySse2(uint32_t* buffer, uint32_t count, uint16_t multiplier)
+{
+	__m128i zero = _mm_setzero_si128();
+	__m128i mult = _mm_set1_epi16((short)multiplier);
+	__m128i alpha = _mm_set1_epi32((int)0xFF000000);
+
+	uint32_t i = 0;
+	for(; i + 4 <= count; i += 4) {
+		__m128i pixels = _mm_loadu_si128((__m128i*)(buffer + i));
+		__m128i lo = _mm_mulhi_epu16(_mm_unpacklo_epi8(pixels, zero), mult);
+		__m128i hi = _mm_mulhi_epu16(_mm_unpackhi_epi8(pixels, zero), mult);
+		_mm_storeu_si128((__m128i*)(buffer + i), _mm_or_si128(_mm_packus_epi16(lo, hi), alpha));
+	}
+	return i;
+}
+
+AVX2_FUNC static uint32_t ApplyScanlineIntensityAvx2(uint32_t* buffer, uint32_t count, uint16_t multiplier)
+{
+	__m256i zero = _mm256_setzero_si256();
+	__m256i mult = _mm256_set1_epi16((short)multiplier);
+	__m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+
+	uint32_t i = 0;
+	for(; i + 8 <= count; i += 8) {
+		__m256i pixels = _mm256_loadu_si256((__m256i*)(buffer + i));
+		__m256i lo = _mm256_mulhi_epu16(_mm256_unpacklo_epi8(pixels, zero), mult);
+		__m256i hi = _mm256_mulhi_epu16(_mm256_unpackhi_epi8(pixels, zero), mult);
+		_mm256_storeu_si256((__m256i*)(buffer + i), _mm256_or_si256(_mm256_packus_epi16(lo, hi), alpha));
+	}
+	return i;
+}
+#endif
+
+void VideoFilterKernels::ConvertRgb555ToArgb(uint16_t* src, uint32_t* dst, uint32_t count, uint8_t scanlineIntensity)
+{
+	uint32_t i = 0;
+#ifdef VIDEO_KERNELS_X86
+	switch(GetSimdLevel()) {
+		case SimdLevel::Avx2: i = ConvertRgb555ToArgbAvx2(src, dst, count, scanlineIntensity); break;
+		case SimdLevel::Sse2: i = ConvertRgb555ToArgbSse2(src, dst, count, scanlineIntensity); break;
+		default: break;
+	}
+#endif
+
+	for(; i < count; i++) {
+		uint8_t r = ApplyIntensity(To8Bit(src[i] & 0x1F), scanlineIntensity);
+		uint8_t g = ApplyIntensity(To8Bit((src[i] >> 5) & 0x1F), scanlineIntensity);
+		uint8_t b = ApplyIntensity(To8Bit((src[i] >> 10) & 0x1F), scanlineIntensity);
+		dst[i] = 0xFF000000 | (r << 16) | (g << 8) | b;
+	}
+}
+
+void VideoFilterKernels::ScaleRow(uint32_t* src, uint32_t* dst, uint32_t count, uint32_t scale)
+{
+	uint32_t i = 0;
+#ifdef VIDEO_KERNELS_X86
+	if(GetSimdLevel() != SimdLevel::None) {
+		i = ScaleRowSse2(src, dst, count, scale);
+	}
+#endif
+
+	for(; i < count; i++) {
+		for(uint32_t j = 0; j < scale; j++) {
+			dst[i * scale + j] = src[i];
+		}
+	}
+}
+
+void VideoFilterKernels::GetIntensityMultiplier(double intensity, ScanlineIntensityMultiplier &multiplier)
+{
+	//Find a 16-bit fixed point multiplier that gives the exact same results as the floating point multiplication
+	for(int i = 0; i < 256; i++) {
+		multiplier.Lut[i] = (uint8_t)(i * intensity);
+	}
+
+	multiplier.Multiplier = 0;
+	multiplier.UseMultiplier = false;
+
+	int base = (int)(intensity * 65536);
+	for(int m = std::max(0, base - 2); m <= std::min(0xFFFF, base + 2); m++) {
+		bool match = true;
+		for(int i = 0; i < 256 && match; i++) {
+			match = ((i * m) >> 16) == multiplier.Lut[i];
+		}
+		if(match) {
+			multiplier.Multiplier = (uint16_t)m;
+			multiplier.UseMultiplier = true;
+			return;
+		}
+	}
+}
+
+void VideoFilterKernels::ApplyScanlineIntensity(uint32_t* buffer, uint32_t count, const ScanlineIntensityMultiplier &multiplier)
+{
+	const uint8_t* lut = multiplier.Lut;
+
+	uint32_t i = 0;
+#ifdef VIDEO_KERNELS_X86
+	if(multiplier.UseMultiplier) {
+		switch(GetSimdLevel()) {
+			case SimdLevel::Avx2: i = ApplyScanlineIntensityAvx2(buffer, count, multiplier.Multiplier); break;
+			case SimdLevel::Sse2: i = ApplyScanlineIntensitySse2(buffer, count, multiplier.Multiplier); break;
+			default: break;
+		}
+	}
+#endif
+
+	for(; i < count; i++) {
+		uint32_t color = buffer[i];
+		buffer[i] = 0xFF000000 | (lut[(color >> 16) & 0xFF] << 16) | (lut[(color >> 8) & 0xFF] << 8) | lut[color & 0xFF];
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "stdafx.h"
+
+//Scanline intensity lookup table and equivalent fixed point multiplier, computed once per frame
+struct ScanlineIntensityMultiplier
+{
+	uint8_t Lut[256];
+	uint16_t Multiplier;
+	bool UseMultiplier;
+};
+
+//Pixel conversion loops used by the video filters, with SSE2/AVX2 versions selected at runtime (and a scalar fallback)
+class VideoFilterKernels
+{
+private:
+	enum class SimdLevel
+	{
+		None,
+		Sse2,
+		Avx2
+	};
+
+	static SimdLevel GetSimdLevel();
+
+public:
+	//Converts RGB555 pixels to ARGB (same output as DefaultVideoFilter::ToArgb) and applies the scanline intensity (255 = no effect)
+	static void ConvertRgb555ToArgb(uint16_t* src, uint32_t* dst, uint32_t count, uint8_t scanlineIntensity);
+
+	//Writes each pixel "scale" times in a row
+	static void ScaleRow(uint32_t* src, uint32_t* dst, uint32_t count, uint32_t scale);
+
+	//Prepares the multiplier used by ApplyScanlineIntensity for the given intensity
+	static void GetIntensityMultiplier(double intensity, ScanlineIntensityMultiplier &multiplier);
+
+	//Multiplies each color channel by the intensity (truncated), and sets alpha to 0xFF
+	static void ApplyScanlineIntensity(uint32_t* buffer, uint32_t count, const ScanlineIntensityMultiplier &multiplier);
+};
@@ -115,10 +115,17 @@ void VideoRenderer::AddRecordingSound(int16_t* soundBuffer, uint32_t sampleCount
 void VideoRenderer::StopRecording()
 {
 	shared_ptr<IVideoRecorder> recorder = _recorder;
+	_recorder.reset();
 	if(recorder) {
+		recorder->StopRecording();
+
+		shared_ptr<AviRecorder> aviRecorder = std::dynamic_pointer_cast<AviRecorder>(recorder);
+		if(aviRecorder) {
+			FrameQueueStats stats = aviRecorder->GetStats();
+			MessageManager::Log("[AVI] Frames written: " + std::to_string(stats.FramesProcessed) + ", max queued frames: " + std::to_string(stats.MaxQueuedFrames) + ", encoder stalls: " + std::to_string(stats.StallCount) + " (" + std::to_string((int)stats.StallTime) + " ms)");
+		}
 		MessageManager::DisplayMessage("VideoRecorder", "VideoRecorderStopped", recorder->GetOutputFile());
 	}
-	_recorder.reset();
 }
 
 bool VideoRenderer::IsRecording()
@@ -55,8 +55,9 @@ extern "C"
 	DllExport int32_t __stdcall SearchDisassembly(CpuType type, const char* searchString, int32_t startPosition, int32_t endPosition, bool searchBackwards) { return GetDebugger()->GetDisassembler()->SearchDisassembly(type, searchString, startPosition, endPosition, searchBackwards); }
 
 	DllExport void __stdcall SetTraceOptions(TraceLoggerOptions options) { GetDebugger()->GetTraceLogger()->SetOptions(options); }
-	DllExport void __stdcall StartTraceLogger(char* filename) { GetDebugger()->GetTraceLogger()->StartLogging(filename); }
+	DllExport void __stdcall StartTraceLogger(char* filename, bool binaryFormat) { GetDebugger()->GetTraceLogger()->StartLogging(filename, binaryFormat); }
 	DllExport void __stdcall StopTraceLogger() { GetDebugger()->GetTraceLogger()->StopLogging(); }
+	DllExport bool __stdcall ConvertTraceLog(char* inputFile, char* outputFile) { return GetDebugger()->GetTraceLogger()->ConvertBinaryLog(inputFile, outputFile); }
 	DllExport void __stdcall ClearTraceLog() { GetDebugger()->GetTraceLogger()->Clear(); }
 	DllExport const char* GetExecutionTrace(uint32_t lineCount) { return GetDebugger()->GetTraceLogger()->GetExecutionTrace(lineCount); }
 
@@ -67,8 +68,11 @@ extern "C"
 	DllExport void __stdcall GetCallstack(CpuType cpuType, StackFrameInfo *callstackArray, uint32_t &callstackSize) { GetDebugger()->GetCallstackManager(cpuType)->GetCallstack(callstackArray, callstackSize); }
 	DllExport void __stdcall GetProfilerData(CpuType cpuType, ProfiledFunction* profilerData, uint32_t& functionCount) { GetDebugger()->GetCallstackManager(cpuType)->GetProfiler()->GetProfilerData(profilerData, functionCount); }
 	DllExport void __stdcall ResetProfiler(CpuType cpuType) { GetDebugger()->GetCallstackManager(cpuType)->GetProfiler()->Reset(); }
+	DllExport void __stdcall SetProfilerMode(CpuType cpuType, ProfilerMode mode, uint32_t samplePeriod) { GetDebugger()->GetCallstackManager(cpuType)->GetProfiler()->SetMode(mode, samplePeriod); }
+	DllExport const char* GetProfilerFoldedStacks(CpuType cpuType) { return GetDebugger()->GetCallstackManager(cpuType)->GetProfiler()->GetFoldedStacks(); }
 
-	DllExport void __stdcall GetState(DebugState& state) { GetDebugger()->GetState(state, false); }
+	DllExport void __stdcall GetState(DebugState& state) { GetDebugger()->GetStateSnapshot(state); }
+	DllExport void __stdcall GetStateWithGenerations(DebugState& state, DebugStateGenerations& generations) { GetDebugger()->GetStateSnapshot(state, &generations); }
 	DllExport bool __stdcall GetCpuProcFlag(ProcFlags::ProcFlags flag) { return GetDebugger()->GetCpuProcFlag(flag); }
 
 	DllExport void __stdcall SetCpuRegister(CpuRegister reg, uint16_t value) { GetDebugger()->SetCpuRegister(reg, value); }
@@ -67,4 +67,10 @@ public:
 	{
 		return AudioStatistics();
 	}
+
+	virtual bool RequiresSynchronousOutput() override
+	{
+		//Audio must be sent to the frontend before retro_run returns
+		return true;
+	}
 };
@@ -30,12 +30,7 @@ void SdlSoundManager::Release()
 	if(_audioDeviceID != 0) {
 		Stop();
 		SDL_CloseAudioDevice(_audioDeviceID);
-	}
-
-	if(_buffer) {
-		delete[] _buffer;
-		_buffer = nullptr;
-		_bufferSize = 0;
+		_audioDeviceID = 0;
 	}
 }
 
@@ -55,8 +50,7 @@ bool SdlSoundManager::InitializeAudio(uint32_t sampleRate, bool isStereo)
 	int bytesPerSample = 2 * (isStereo ? 2 : 1);
 	int32_t requestedByteLatency = (int32_t)((float)(sampleRate * _previousLatency) / 1000.0f * bytesPerSample);
 	_bufferSize = (int32_t)std::ceil((double)requestedByteLatency * 2 / 0x10000) * 0x10000;
-	_buffer = new uint8_t[_bufferSize];
-	memset(_buffer, 0, _bufferSize);
+	_buffer.SetCapacity(_bufferSize);
 
 	SDL_AudioSpec audioSpec;
 	SDL_memset(&audioSpec, 0, sizeof(audioSpec));
@@ -75,9 +69,6 @@ bool SdlSoundManager::InitializeAudio(uint32_t sampleRate, bool isStereo)
 		_audioDeviceID = SDL_OpenAudioDevice(nullptr, isCapture, &audioSpec, &obtainedSpec, 0);
 	}
 
-	_writePosition = 0;
-	_readPosition = 0;
-
 	_needReset = false;
 
 	return _audioDeviceID != 0;
@@ -119,33 +110,22 @@ void SdlSoundManager::SetAudioDevice(string deviceName)
 
 void SdlSoundManager::ReadFromBuffer(uint8_t* output, uint32_t len)
 {
-	if(_readPosition + len < _bufferSize) {
-		memcpy(output, _buffer+_readPosition, len);
-		_readPosition += len;
-	} else {
-		int remainingBytes = (_bufferSize - _readPosition);
-		memcpy(output, _buffer+_readPosition, remainingBytes);
-		memcpy(output+remainingBytes, _buffer, len - remainingBytes);
-		_readPosition = len - remainingBytes;
-	}
-
-	if(_readPosition >= _writePosition && _readPosition - _writePosition < _bufferSize / 2) {
+	uint32_t readBytes = _buffer.Read(output, len);
+	if(readBytes < len) {
+		//Not enough data, play silence instead of stale samples
+		memset(output + readBytes, 0, len - readBytes);
 		_bufferUnderrunEventCount++;
 	}
 }
 
-void SdlSoundManager::WriteToBuffer(uint8_t* input, uint32_t len)
+void SdlSoundManager::WriteToBuffer(uint8_t* input, uint32_t len, uint32_t bytesPerSample)
 {
-	if(_writePosition + len < _bufferSize) {
-		memcpy(_buffer+_writePosition, input, len);
-		_writePosition += len;
-	} else {
-		int remainingBytes = _bufferSize - _writePosition;
-		memcpy(_buffer+_writePosition, input, remainingBytes);
-		memcpy(_buffer, ((uint8_t*)input)+remainingBytes, len - remainingBytes);
-		_writePosition = len - remainingBytes;
-	}
+	//Only write whole sample frames - a partial frame would misalign every sample that follows it
+	//When the buffer is full, the samples that don't fit are dropped
+	len = std::min(len, _buffer.GetWriteSpace()) / bytesPerSample * bytesPerSample;
+	_buffer.Write(input, len);
 }
+
 void SdlSoundManager::PlayBuffer(int16_t *soundBuffer, uint32_t sampleCount, uint32_t sampleRate, bool isStereo)
 {
 	uint32_t bytesPerSample = 2 * (isStereo ? 2 : 1);
@@ -155,13 +135,10 @@ void SdlSoundManager::PlayBuffer(int16_t *soundBuffer, uint32_t sampleCount, uin
 		InitializeAudio(sampleRate, isStereo);
 	}
 
-	WriteToBuffer((uint8_t*)soundBuffer, sampleCount * bytesPerSample);
+	WriteToBuffer((uint8_t*)soundBuffer, sampleCount * bytesPerSample, bytesPerSample);
 
 	int32_t byteLatency = (int32_t)((float)(sampleRate * latency) / 1000.0f * bytesPerSample);
-	int32_t playWriteByteLatency = _writePosition - _readPosition;
-	if(playWriteByteLatency < 0) {
-		playWriteByteLatency = _bufferSize - _readPosition + _writePosition;
-	}
+	int32_t playWriteByteLatency = (int32_t)_buffer.GetReadCount();
 
 	if(playWriteByteLatency > byteLatency) {
 		//Start playing
@@ -178,14 +155,16 @@ void SdlSoundManager::Stop()
 {
 	Pause();
 
-	_readPosition = 0;
-	_writePosition = 0;
+	//The callback can't run while the device is locked, so the buffer can be safely reset
+	SDL_LockAudioDevice(_audioDeviceID);
+	_buffer.Clear();
+	SDL_UnlockAudioDevice(_audioDeviceID);
 	ResetStats();
 }
 
 void SdlSoundManager::ProcessEndOfFrame()
 {
-	ProcessLatency(_readPosition, _writePosition);
+	ProcessLatency(0, _buffer.GetReadCount());
 
 	uint32_t emulationSpeed = _console->GetSettings()->GetEmulationSpeed();
 	if(_averageLatency > 0 && emulationSpeed <= 100 && emulationSpeed > 0 && std::abs(_averageLatency - _console->GetSettings()->GetAudioConfig().AudioLatency) > 50) {
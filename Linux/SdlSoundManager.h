@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <SDL2/SDL.h>
 #include "../Core/BaseSoundManager.h"
+#include "../Utilities/SpscRingBuffer.h"
 
 class Console;
 
@@ -27,17 +28,16 @@ private:
 	static void FillAudioBuffer(void *userData, uint8_t *stream, int len);
 
 	void ReadFromBuffer(uint8_t* output, uint32_t len);
-	void WriteToBuffer(uint8_t* output, uint32_t len);
+	void WriteToBuffer(uint8_t* input, uint32_t len, uint32_t bytesPerSample);
 
 private:
 	shared_ptr<Console> _console;
-	SDL_AudioDeviceID _audioDeviceID;
+	SDL_AudioDeviceID _audioDeviceID = 0;
 	string _deviceName;
 	bool _needReset = false;
 
 	uint16_t _previousLatency = 0;
 
-	uint8_t* _buffer = nullptr;
-	uint32_t _writePosition = 0;
-	uint32_t _readPosition = 0;
+	//Written by the mixer thread, read by SDL's audio callback
+	SpscRingBuffer<uint8_t> _buffer;
 };
@@ -22,6 +22,10 @@ namespace Mesen.GUI.Debugger
 
 		private WindowRefreshManager _refreshManager;
 		private DebugState _state;
+		private DebugStateGenerations _generations;
+		private TabPage _shownTab;
+		private UInt32 _shownGeneration;
+		private UInt32 _shownIrqRegisters;
 		private byte _reg4210;
 		private byte _reg4211;
 		private byte _reg4212;
@@ -92,6 +96,7 @@ namespace Mesen.GUI.Debugger
 		{
 			tabMain.SelectedIndexChanged -= tabMain_SelectedIndexChanged;
 			_coprocessorType = EmuApi.GetRomInfo().CoprocessorType;
+			_shownTab = null;
 
 			tabMain.TabPages.Clear();
 			if(_coprocessorType != CoprocessorType.Gameboy) {
@@ -135,14 +140,41 @@ namespace Mesen.GUI.Debugger
 		
 		public void RefreshData()
 		{
-			_state = DebugApi.GetState();
+			_state = DebugApi.GetState(out _generations);
 			_reg4210 = DebugApi.GetMemoryValue(SnesMemoryType.CpuMemory, 0x4210);
 			_reg4211 = DebugApi.GetMemoryValue(SnesMemoryType.CpuMemory, 0x4211);
 			_reg4212 = DebugApi.GetMemoryValue(SnesMemoryType.CpuMemory, 0x4212);
 		}
 
+		private UInt32 GetTabGeneration(TabPage tab)
+		{
+			if(tab == tpgCpu || tab == tpgDma) {
+				return _generations.Dma;
+			} else if(tab == tpgSpc) {
+				return _generations.Spc;
+			} else if(tab == tpgDsp) {
+				return _generations.Dsp;
+			} else if(tab == tpgPpu) {
+				return _generations.Ppu;
+			} else if(tab == tpgCoprocessor) {
+				return _coprocessorType == CoprocessorType.SA1 ? _generations.Coprocessor : _generations.Gameboy;
+			}
+			return _generations.State;
+		}
+
 		public void RefreshViewer()
 		{
+			//Only update the selected tab when its part of the state has changed
+			UInt32 generation = GetTabGeneration(tabMain.SelectedTab);
+			//The CPU tab also displays $4210-$4212, which are not part of the state
+			UInt32 irqRegisters = tabMain.SelectedTab == tpgCpu ? (UInt32)((_reg4210 << 16) | (_reg4211 << 8) | _reg4212) : 0;
+			if(tabMain.SelectedTab == _shownTab && generation == _shownGeneration && irqRegisters == _shownIrqRegisters) {
+				return;
+			}
+			_shownTab = tabMain.SelectedTab;
+			_shownGeneration = generation;
+			_shownIrqRegisters = irqRegisters;
+
 			if(tabMain.SelectedTab == tpgCpu) {
 				UpdateCpuTab();
 			} else if(tabMain.SelectedTab == tpgDma) {
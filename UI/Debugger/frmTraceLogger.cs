@@ -282,14 +282,14 @@ namespace Mesen.GUI.Debugger
 		private void btnStartLogging_Click(object sender, EventArgs e)
 		{
 			using(SaveFileDialog sfd = new SaveFileDialog()) {
-				sfd.SetFilter("Trace logs (*.txt)|*.txt");
+				sfd.SetFilter("Trace logs (*.txt)|*.txt|Binary trace logs (*.mtrc)|*.mtrc");
 				sfd.FileName = "Trace.txt";
 				sfd.InitialDirectory = ConfigManager.DebuggerFolder;
 				if(sfd.ShowDialog() == DialogResult.OK) {
 					_lastFilename = sfd.FileName;
 					_interopOptions = GetInteropOptions();
 					SetCoreOptions();
-					DebugApi.StartTraceLogger(sfd.FileName);
+					DebugApi.StartTraceLogger(sfd.FileName, IsBinaryTrace(sfd.FileName));
 
 					btnStartLogging.Enabled = false;
 					btnStopLogging.Enabled = true;
@@ -308,10 +308,46 @@ namespace Mesen.GUI.Debugger
 			btnOpenTrace.Enabled = true;
 		}
 
+		private bool IsBinaryTrace(string filename)
+		{
+			return Path.GetExtension(filename).Equals(".mtrc", StringComparison.InvariantCultureIgnoreCase);
+		}
+
 		private void btnOpenTrace_Click(object sender, EventArgs e)
+		{
+			string filename = _lastFilename;
+			if(IsBinaryTrace(filename)) {
+				//Binary logs are converted to text using the current format options
+				//Large logs can take a while to convert, so this is done in another thread
+				string binaryFilename = filename;
+				filename = Path.ChangeExtension(filename, ".txt");
+				_interopOptions = GetInteropOptions();
+				btnOpenTrace.Enabled = false;
+				btnStartLogging.Enabled = false;
+				Task.Run(() => {
+					SetCoreOptions();
+					bool converted = DebugApi.ConvertTraceLog(binaryFilename, filename);
+					if(this.IsDisposed) {
+						return;
+					}
+
+					this.BeginInvoke((Action)(() => {
+						btnOpenTrace.Enabled = true;
+						btnStartLogging.Enabled = true;
+						if(converted) {
+							OpenTraceFile(filename);
+						}
+					}));
+				});
+			} else {
+				OpenTraceFile(filename);
+			}
+		}
+
+		private void OpenTraceFile(string filename)
 		{
 			try {
-				System.Diagnostics.Process.Start(_lastFilename);
+				System.Diagnostics.Process.Start(filename);
 			} catch { }
 		}
 
@@ -22,8 +22,9 @@ namespace Mesen.GUI
 		[DllImport(DllPath)] public static extern void ResumeExecution();
 		[DllImport(DllPath)] public static extern void Step(CpuType cpuType, Int32 instructionCount, StepType type = StepType.Step);
 
-		[DllImport(DllPath)] public static extern void StartTraceLogger([MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(Utf8Marshaler))]string filename);
+		[DllImport(DllPath)] public static extern void StartTraceLogger([MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(Utf8Marshaler))]string filename, [MarshalAs(UnmanagedType.I1)]bool binaryFormat);
 		[DllImport(DllPath)] public static extern void StopTraceLogger();
+		[DllImport(DllPath)] [return: MarshalAs(UnmanagedType.I1)] public static extern bool ConvertTraceLog([MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(Utf8Marshaler))]string inputFile, [MarshalAs(UnmanagedType.CustomMarshaler, MarshalTypeRef = typeof(Utf8Marshaler))]string outputFile);
 		[DllImport(DllPath)] public static extern void SetTraceOptions(InteropTraceLoggerOptions options);
 		[DllImport(DllPath)] public static extern void ClearTraceLog();
 
@@ -58,6 +59,15 @@ namespace Mesen.GUI
 			return state;
 		}
 
+		[DllImport(DllPath, EntryPoint = "GetStateWithGenerations")] private static extern void GetStateWithGenerationsWrapper(ref DebugState state, ref DebugStateGenerations generations);
+		public static DebugState GetState(out DebugStateGenerations generations)
+		{
+			DebugState state = new DebugState();
+			generations = new DebugStateGenerations();
+			DebugApi.GetStateWithGenerationsWrapper(ref state, ref generations);
+			return state;
+		}
+
 		[DllImport(DllPath)] public static extern void SetCpuRegister(CpuRegister reg, UInt16 value);
 		[DllImport(DllPath)] public static extern void SetCpuProcFlag(ProcFlags flag, [MarshalAs(UnmanagedType.I1)]bool set);
 		[DllImport(DllPath)] public static extern void SetSpcRegister(SpcRegister reg, UInt16 value);
@@ -163,6 +173,10 @@ namespace Mesen.GUI
 			return profilerData;
 		}
 
+		[DllImport(DllPath)] public static extern void SetProfilerMode(CpuType type, ProfilerMode mode, UInt32 samplePeriod);
+		[DllImport(DllPath, EntryPoint = "GetProfilerFoldedStacks")] private static extern IntPtr GetProfilerFoldedStacksWrapper(CpuType type);
+		public static string GetProfilerFoldedStacks(CpuType type) { return Utf8Marshaler.PtrToStringUtf8(DebugApi.GetProfilerFoldedStacksWrapper(type)); }
+
 		[DllImport(DllPath)] public static extern void ResetMemoryAccessCounts();
 		public static void GetMemoryAccessCounts(SnesMemoryType type, ref AddressCounters[] counters)
 		{
@@ -674,6 +688,12 @@ namespace Mesen.GUI
 		MemoryMode8 = 0x20,
 	}
 
+	public enum ProfilerMode
+	{
+		Exact = 0,
+		Sampling = 1
+	}
+
 	public struct ProfiledFunction
 	{
 		public UInt64 ExclusiveCycles;
@@ -926,6 +926,18 @@ namespace Mesen.GUI
 		public AluState Alu;
 	}
 
+	public struct DebugStateGenerations
+	{
+		public UInt32 State;
+		public UInt32 Cpu;
+		public UInt32 Ppu;
+		public UInt32 Spc;
+		public UInt32 Dsp;
+		public UInt32 Dma;
+		public UInt32 Coprocessor;
+		public UInt32 Gameboy;
+	}
+
 	public enum CpuRegister : byte
 	{
 		CpuRegA,
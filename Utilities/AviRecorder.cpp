@@ -4,8 +4,6 @@
 AviRecorder::AviRecorder(VideoCodec codec, uint32_t compressionLevel)
 {
 	_recording = false;
-	_stopFlag = false;
-	_frameBuffer = nullptr;
 	_frameBufferLength = 0;
 	_sampleRate = 0;
 	_codec = codec;
@@ -14,14 +12,7 @@ AviRecorder::AviRecorder(VideoCodec codec, uint32_t compressionLevel)
 
 AviRecorder::~AviRecorder()
 {
-	if(_recording) {
-		StopRecording();
-	}
-
-	if(_frameBuffer) {
-		delete[] _frameBuffer;
-		_frameBuffer = nullptr;
-	}
+	StopRecording();
 }
 
 bool AviRecorder::StartRecording(string filename, uint32_t width, uint32_t height, uint32_t bpp, uint32_t audioSampleRate, double fps)
@@ -33,7 +24,6 @@ bool AviRecorder::StartRecording(string filename, uint32_t width, uint32_t heigh
 		_height = height;
 		_fps = fps;
 		_frameBufferLength = height * width * bpp;
-		_frameBuffer = new uint8_t[_frameBufferLength];
 
 		_aviWriter.reset(new AviWriter());
 		if(!_aviWriter->StartWrite(filename, _codec, width, height, bpp, (uint32_t)(_fps * 1000000), audioSampleRate, _compressionLevel)) {
@@ -41,35 +31,40 @@ bool AviRecorder::StartRecording(string filename, uint32_t width, uint32_t heigh
 			return false;
 		}
 
-		_aviWriterThread = std::thread([=]() {
-			while(!_stopFlag) {
-				_waitFrame.Wait();
-				if(_stopFlag) {
-					break;
-				}
-
-				auto lock = _lock.AcquireSafe();
-				_aviWriter->AddFrame(_frameBuffer);
-			}
-		});
-
+		_queue.Start(std::max(MinQueueFrames, MaxQueueBytes / std::max(_frameBufferLength, 1u)));
 		_recording = true;
+		_aviWriterThread = std::thread(&AviRecorder::WriterThread, this);
 	}
 	return true;
 }
 
+void AviRecorder::WriterThread()
+{
+	FrameQueue::Item item;
+	while(_queue.Pop(item)) {
+		if(item.IsFrame) {
+			_aviWriter->AddFrame(item.Data.data());
+		} else {
+			_aviWriter->AddSound((int16_t*)item.Data.data(), (uint32_t)item.Data.size() / 4);
+		}
+		_queue.Release(item);
+	}
+}
+
 void AviRecorder::StopRecording()
 {
-	if(_recording) {
-		_recording = false;
+	if(!_recording.exchange(false)) {
+		return;
+	}
 
-		_stopFlag = true;
-		_waitFrame.Signal();
-		_aviWriterThread.join();
+	//The writer thread drains whatever is still queued before exiting
+	_queue.Stop();
+	_aviWriterThread.join();
 
-		_aviWriter->EndWrite();
-		_aviWriter.reset();
-	}
+	_aviWriter->EndWrite();
+	_aviWriter.reset();
+
+	_queue.Clear();
 }
 
 void AviRecorder::AddFrame(void* frameBuffer, uint32_t width, uint32_t height, double fps)
@@ -78,9 +73,7 @@ void AviRecorder::AddFrame(void* frameBuffer, uint32_t width, uint32_t height, d
 		if(_width != width || _height != height || _fps != fps) {
 			StopRecording();
 		} else {
-			auto lock = _lock.AcquireSafe();
-			memcpy(_frameBuffer, frameBuffer, _frameBufferLength);
-			_waitFrame.Signal();
+			_queue.Push(frameBuffer, _frameBufferLength, true);
 		}
 	}
 }
@@ -89,10 +82,9 @@ void AviRecorder::AddSound(int16_t* soundBuffer, uint32_t sampleCount, uint32_t
 {
 	if(_recording) {
 		if(_sampleRate != sampleRate) {
-			auto lock = _lock.AcquireSafe();
 			StopRecording();
 		} else {
-			_aviWriter->AddSound(soundBuffer, sampleCount);
+			_queue.Push(soundBuffer, sampleCount * 4, false);
 		}
 	}
 }
@@ -105,4 +97,9 @@ bool AviRecorder::IsRecording()
 string AviRecorder::GetOutputFile()
 {
 	return _outputFile;
-}
\ No newline at end of file
+}
+
+FrameQueueStats AviRecorder::GetStats()
+{
+	return _queue.GetStats();
+}
@@ -1,9 +1,8 @@
 #pragma once
 #include "stdafx.h"
 #include <thread>
-#include "AutoResetEvent.h"
 #include "AviWriter.h"
-#include "SimpleLock.h"
+#include "FrameQueue.h"
 #include "IVideoRecorder.h"
 
 class Console;
@@ -11,17 +10,20 @@ class Console;
 class AviRecorder : public IVideoRecorder
 {
 private:
+	//Max amount of video waiting to be encoded before AddFrame waits for the writer thread
+	static constexpr uint32_t MaxQueueBytes = 128 * 1024 * 1024;
+	static constexpr uint32_t MinQueueFrames = 8;
+
 	std::thread _aviWriterThread;
 	
 	unique_ptr<AviWriter> _aviWriter;
 
 	string _outputFile;
-	SimpleLock _lock;
-	AutoResetEvent _waitFrame;
 
-	atomic<bool> _stopFlag;	
-	bool _recording;
-	uint8_t* _frameBuffer;
+	//Video frames and audio are queued in the order they were received, so the chunk layout matches what AviWriter expects
+	FrameQueue _queue;
+
+	atomic<bool> _recording;
 	uint32_t _frameBufferLength;
 	uint32_t _sampleRate;
 
@@ -32,6 +34,8 @@ private:
 	VideoCodec _codec;
 	uint32_t _compressionLevel;
 
+	void WriterThread();
+
 public:
 	AviRecorder(VideoCodec codec, uint32_t compressionLevel);
 	virtual ~AviRecorder();
@@ -44,4 +48,6 @@ public:
 
 	bool IsRecording() override;
 	string GetOutputFile() override;
-};
\ No newline at end of file
+
+	FrameQueueStats GetStats();
+};
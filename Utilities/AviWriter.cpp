@@ -83,6 +83,12 @@ bool AviWriter::StartWrite(string filename, VideoCodec codec, uint32_t width, ui
 		return false;
 	}
 
+	uint32_t batchSize = std::max(_codec->GetMaxFrameBatchSize(), 1u);
+	_batchFrames = vector<CodecFrame>(batchSize);
+	_batchFrameData = vector<vector<uint8_t>>(batchSize);
+	_batchAudio = vector<vector<uint8_t>>(batchSize);
+	_batchSize = 0;
+
 	_frameBuffer = new uint8_t[width*height*bpp];
 
 	_aviIndex.clear();
@@ -108,6 +114,10 @@ bool AviWriter::StartWrite(string filename, VideoCodec codec, uint32_t width, ui
 
 void AviWriter::EndWrite()
 {
+	if(_batchSize) {
+		WriteFrameBatch();
+	}
+
 	/* Close the video */
 	uint8_t avi_header[AviWriter::AviHeaderSize];
 	uint32_t main_list;
@@ -239,26 +249,51 @@ void AviWriter::AddFrame(uint8_t *frameData)
 		return;
 	}
 
-	bool isKeyFrame = (_frames % 120 == 0) ? 1 : 0;
+	CodecFrame& frame = _batchFrames[_batchSize];
+	if(_batchFrames.size() > 1) {
+		//The frame is compressed later, keep a copy of it
+		vector<uint8_t>& frameCopy = _batchFrameData[_batchSize];
+		frameCopy.assign(frameData, frameData + _width * _height * _bpp);
+		frameData = frameCopy.data();
+	}
+	frame.FrameData = frameData;
 
-	uint8_t* compressedData = nullptr;
-	int written = _codec->CompressFrame(isKeyFrame, frameData, &compressedData);
-	if(written < 0) {
-		return;
+	{
+		auto lock = _audioLock.AcquireSafe();
+		uint8_t* audio = (uint8_t*)_audiobuf;
+		_batchAudio[_batchSize].assign(audio, audio + _audioPos);
+		_audioPos = 0;
+	}
+
+	_batchSize++;
+	if(_batchSize == _batchFrames.size()) {
+		WriteFrameBatch();
 	}
+}
 
-	if(_codecType == VideoCodec::None) {
-		isKeyFrame = true;
+void AviWriter::WriteFrameBatch()
+{
+	for(uint32_t i = 0; i < _batchSize; i++) {
+		_batchFrames[i].IsKeyFrame = ((_frames + i) % 120 == 0) ? 1 : 0;
 	}
-	WriteAviChunk(_codecType == VideoCodec::None ? "00db" : "00dc", written, compressedData, isKeyFrame ? 0x10 : 0);
-	_frames++;
 
-	if(_audioPos) {
-		auto lock = _audioLock.AcquireSafe();
-		WriteAviChunk("01wb", _audioPos, _audiobuf, 0);
-		_audiowritten += _audioPos;
-		_audioPos = 0;
+	_codec->CompressFrames(_batchFrames.data(), _batchSize);
+
+	for(uint32_t i = 0; i < _batchSize; i++) {
+		CodecFrame& frame = _batchFrames[i];
+		if(frame.CompressedSize >= 0) {
+			bool isKeyFrame = frame.IsKeyFrame || _codecType == VideoCodec::None;
+			WriteAviChunk(_codecType == VideoCodec::None ? "00db" : "00dc", frame.CompressedSize, frame.CompressedData, isKeyFrame ? 0x10 : 0);
+			_frames++;
+		}
+
+		vector<uint8_t>& audio = _batchAudio[i];
+		if(!audio.empty()) {
+			WriteAviChunk("01wb", (uint32_t)audio.size(), audio.data(), 0);
+			_audiowritten += (uint32_t)audio.size();
+		}
 	}
+	_batchSize = 0;
 }
 
 void AviWriter::AddSound(int16_t *data, uint32_t sampleCount)
@@ -268,6 +303,24 @@ void AviWriter::AddSound(int16_t *data, uint32_t sampleCount)
 	}
 
 	auto lock = _audioLock.AcquireSafe();
-	memcpy(_audiobuf+_audioPos/2, data, sampleCount * 4);
-	_audioPos += sampleCount * 4;
+	uint32_t size = sampleCount * 4;
+	if(_audioPos + size > sizeof(_audiobuf)) {
+		//Buffer would overflow (e.g several audio batches between 2 frames), write what we have first
+		if(_batchSize) {
+			//Frames received before this audio must be written first
+			WriteFrameBatch();
+		}
+		if(_audioPos) {
+			WriteAviChunk("01wb", _audioPos, _audiobuf, 0);
+			_audiowritten += _audioPos;
+			_audioPos = 0;
+		}
+		if(size > sizeof(_audiobuf)) {
+			WriteAviChunk("01wb", size, data, 0);
+			_audiowritten += size;
+			return;
+		}
+	}
+	memcpy(_audiobuf+_audioPos/2, data, size);
+	_audioPos += size;
 }
\ No newline at end of file
@@ -43,10 +43,18 @@ private:
 	
 	SimpleLock _audioLock;
 
+	//Frames waiting to be compressed (for codecs that compress several frames at once)
+	//Each frame is written with the audio that was received before it, like when frames are compressed one at a time
+	vector<CodecFrame> _batchFrames;
+	vector<vector<uint8_t>> _batchFrameData;
+	vector<vector<uint8_t>> _batchAudio;
+	uint32_t _batchSize = 0;
+
 private:
 	void host_writew(uint8_t* buffer, uint16_t value);
 	void host_writed(uint8_t* buffer, uint32_t value);
 	void WriteAviChunk(const char * tag, uint32_t size, void * data, uint32_t flags);
+	void WriteFrameBatch();
 
 public:
 	void AddFrame(uint8_t* frameData);
@@ -1,6 +1,14 @@
 #pragma once
 #include "stdafx.h"
 
+struct CodecFrame
+{
+	bool IsKeyFrame;
+	uint8_t* FrameData;
+	uint8_t* CompressedData;
+	int CompressedSize;
+};
+
 class BaseCodec
 {
 public:
@@ -8,5 +16,15 @@ public:
 	virtual int CompressFrame(bool isKeyFrame, uint8_t *frameData, uint8_t** compressedData) = 0;
 	virtual const char* GetFourCC() = 0;
 
+	//Codecs that compress each frame into its own stream can compress several consecutive frames at once (e.g in parallel)
+	virtual uint32_t GetMaxFrameBatchSize() { return 1; }
+
+	//Compresses frames in order - the compressed data stays valid until the next call
+	virtual void CompressFrames(CodecFrame* frames, uint32_t frameCount)
+	{
+		//The compressed data is only valid until the next CompressFrame call, so this only supports batches of 1 frame
+		frames[0].CompressedSize = CompressFrame(frames[0].IsKeyFrame, frames[0].FrameData, &frames[0].CompressedData);
+	}
+
 	virtual ~BaseCodec() { }
 };
\ No newline at end of file
@@ -7,11 +7,13 @@
 
 CamstudioCodec::~CamstudioCodec()
 {
+	for(uint32_t i = 0; i < _slotCount; i++) {
+		delete[] _slots[i].Frame;
+		delete[] _slots[i].Buffer;
+		delete[] _slots[i].CompressBuffer;
+		deflateEnd(&_slots[i].Compressor);
+	}
 	delete[] _prevFrame;
-	delete[] _currentFrame;
-	delete[] _buffer;
-	delete[] _compressBuffer;
-	deflateEnd(&_compressor);
 }
 
 bool CamstudioCodec::SetupCompress(int width, int height, uint32_t compressionLevel)
@@ -27,18 +29,23 @@ bool CamstudioCodec::SetupCompress(int width, int height, uint32_t compressionLe
 	_height = height;
 
 	_prevFrame = new uint8_t[_rowStride*_height]; //24-bit RGB
-	_currentFrame = new uint8_t[_rowStride*_height]; //24-bit RGB
-	_buffer = new uint8_t[_rowStride*_height]; //24-bit RGB
+	memset(_prevFrame, 0, _rowStride * _height);
 
 	_compressBufferLength = compressBound(_rowStride*_height) + 2;
-	_compressBuffer = new uint8_t[_compressBufferLength];
-	
-	memset(_prevFrame, 0, _rowStride * _height);
-	memset(_currentFrame, 0, _rowStride * _height);
-	memset(_buffer, 0, _rowStride * _height);
-	memset(_compressBuffer, 0, _compressBufferLength);
-	
-	deflateInit(&_compressor, compressionLevel);
+
+	_threadPool.reset(new ThreadPool(ThreadPool::GetDefaultThreadCount(4)));
+	_slotCount = _threadPool->GetThreadCount();
+	_slots.reset(new FrameSlot[_slotCount]);
+	for(uint32_t i = 0; i < _slotCount; i++) {
+		FrameSlot& slot = _slots[i];
+		slot.Frame = new uint8_t[_rowStride*_height];
+		slot.Buffer = new uint8_t[_rowStride*_height];
+		slot.CompressBuffer = new uint8_t[_compressBufferLength];
+		memset(slot.Frame, 0, _rowStride * _height);
+		memset(slot.Buffer, 0, _rowStride * _height);
+		memset(slot.CompressBuffer, 0, _compressBufferLength);
+		deflateInit(&slot.Compressor, compressionLevel);
+	}
 
 	return true;
 }
@@ -54,38 +61,64 @@ void CamstudioCodec::LoadRow(uint8_t* inPointer, uint8_t* outPointer)
 	}
 }
 
-int CamstudioCodec::CompressFrame(bool isKeyFrame, uint8_t *frameData, uint8_t** compressedData)
+int CamstudioCodec::CompressSlot(FrameSlot& slot, bool isKeyFrame, uint8_t* prevFrame)
 {
-	deflateReset(&_compressor);
+	z_stream& compressor = slot.Compressor;
+	deflateReset(&compressor);
 
-	_compressor.next_out = _compressBuffer + 2;
-	_compressor.avail_out = _compressBufferLength - 2;
+	compressor.next_out = slot.CompressBuffer + 2;
+	compressor.avail_out = _compressBufferLength - 2;
 
-	_compressBuffer[0] = (isKeyFrame ? 0x03 : 0x02) | (_compressionLevel << 4);
-	_compressBuffer[1] = 8; //8-bit per color
-
-	uint8_t* rowBuffer = _currentFrame;
-	for(int y = 0; y < _height; y++) {
-		LoadRow(frameData + (_height - y - 1) * _orgWidth * 4, rowBuffer);
-		rowBuffer += _rowStride;
-	}
+	slot.CompressBuffer[0] = (isKeyFrame ? 0x03 : 0x02) | (_compressionLevel << 4);
+	slot.CompressBuffer[1] = 8; //8-bit per color
 
 	if(isKeyFrame) {
-		_compressor.next_in = _currentFrame;
+		compressor.next_in = slot.Frame;
 	} else {
 		for(int i = 0, len = _rowStride * _height; i < len; i++) {
-			_buffer[i] = _currentFrame[i] - _prevFrame[i];
+			slot.Buffer[i] = slot.Frame[i] - prevFrame[i];
 		}
-		_compressor.next_in = _buffer;
+		compressor.next_in = slot.Buffer;
 	}
 
-	memcpy(_prevFrame, _currentFrame, _rowStride*_height);
-	
-	_compressor.avail_in = _height * _rowStride;
-	deflate(&_compressor, MZ_FINISH);
-	
-	*compressedData = _compressBuffer;
-	return _compressor.total_out + 2;
+	compressor.avail_in = _height * _rowStride;
+	deflate(&compressor, MZ_FINISH);
+
+	return compressor.total_out + 2;
+}
+
+int CamstudioCodec::CompressFrame(bool isKeyFrame, uint8_t *frameData, uint8_t** compressedData)
+{
+	CodecFrame frame = { isKeyFrame, frameData };
+	CompressFrames(&frame, 1);
+	*compressedData = frame.CompressedData;
+	return frame.CompressedSize;
+}
+
+uint32_t CamstudioCodec::GetMaxFrameBatchSize()
+{
+	return _slotCount;
+}
+
+void CamstudioCodec::CompressFrames(CodecFrame* frames, uint32_t frameCount)
+{
+	//Converting each frame to 24-bit RGB doesn't depend on the other frames
+	_threadPool->Run(frameCount, [=](uint32_t i) {
+		uint8_t* rowBuffer = _slots[i].Frame;
+		for(int y = 0; y < _height; y++) {
+			LoadRow(frames[i].FrameData + (_height - y - 1) * _orgWidth * 4, rowBuffer);
+			rowBuffer += _rowStride;
+		}
+	});
+
+	//Once every frame is converted, the deltas and the deflate streams can all be computed in parallel
+	_threadPool->Run(frameCount, [=](uint32_t i) {
+		uint8_t* prevFrame = i == 0 ? _prevFrame : _slots[i - 1].Frame;
+		frames[i].CompressedSize = CompressSlot(_slots[i], frames[i].IsKeyFrame, prevFrame);
+		frames[i].CompressedData = _slots[i].CompressBuffer;
+	});
+
+	memcpy(_prevFrame, _slots[frameCount - 1].Frame, _rowStride*_height);
 }
 
 const char* CamstudioCodec::GetFourCC()
@@ -1,18 +1,28 @@
 #pragma once
 #include "stdafx.h"
 #include "BaseCodec.h"
+#include "ThreadPool.h"
 #include "miniz.h"
 
 class CamstudioCodec : public BaseCodec
 {
 private:
+	//Every frame is deflated into its own stream, so each frame of a batch gets its own buffers and compressor
+	struct FrameSlot
+	{
+		uint8_t* Frame = nullptr; //24-bit RGB
+		uint8_t* Buffer = nullptr; //Delta with the previous frame
+		uint8_t* CompressBuffer = nullptr;
+		z_stream Compressor = {};
+	};
+
+	unique_ptr<ThreadPool> _threadPool;
+	unique_ptr<FrameSlot[]> _slots;
+	uint32_t _slotCount = 0;
+
 	uint8_t* _prevFrame = nullptr;
-	uint8_t* _currentFrame = nullptr;
-	uint8_t* _buffer = nullptr;
 
 	uint32_t _compressBufferLength = 0;
-	uint8_t* _compressBuffer = nullptr;
-	z_stream _compressor = {};
 	int _compressionLevel = 0;
 
 	int _orgWidth = 0;
@@ -20,6 +30,7 @@ private:
 	int _height = 0;
 
 	void LoadRow(uint8_t* inPointer, uint8_t* outPointer);
+	int CompressSlot(FrameSlot& slot, bool isKeyFrame, uint8_t* prevFrame);
 
 public:
 	virtual ~CamstudioCodec();
@@ -27,4 +38,7 @@ public:
 	virtual bool SetupCompress(int width, int height, uint32_t compressionLevel) override;
 	virtual int CompressFrame(bool isKeyFrame, uint8_t *frameData, uint8_t** compressedData) override;
 	virtual const char* GetFourCC() override;
+
+	virtual uint32_t GetMaxFrameBatchSize() override;
+	virtual void CompressFrames(CodecFrame* frames, uint32_t frameCount) override;
 };
\ No newline at end of file
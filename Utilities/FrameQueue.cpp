@@ -0,0 +1,91 @@
+#include "stdafx.h"
+#include "FrameQueue.h"
+#include "Timer.h"
+
+void FrameQueue::Start(uint32_t maxQueuedFrames)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	_queue.clear();
+	_queuedFrames = 0;
+	_maxQueuedFrames = std::max(maxQueuedFrames, 1u);
+	_stopFlag = false;
+	_stats = {};
+}
+
+void FrameQueue::Stop()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	_stopFlag = true;
+	_queueSignal.notify_all();
+	_spaceSignal.notify_all();
+}
+
+void FrameQueue::Clear()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	_queue.clear();
+	_bufferPool.clear();
+	_queuedFrames = 0;
+}
+
+bool FrameQueue::Push(void* data, uint32_t size, bool isFrame)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	if(isFrame && _queuedFrames >= _maxQueuedFrames) {
+		//Encoder has fallen behind by more than the queue depth, wait for it rather than losing the frame
+		Timer timer;
+		_spaceSignal.wait(lock, [this]() { return _stopFlag || _queuedFrames < _maxQueuedFrames; });
+		_stats.StallCount++;
+		_stats.StallTime += timer.GetElapsedMS();
+	}
+
+	if(_stopFlag) {
+		return false;
+	}
+
+	Item item = { isFrame };
+	if(!_bufferPool.empty()) {
+		item.Data = std::move(_bufferPool.back());
+		_bufferPool.pop_back();
+	}
+	item.Data.resize(size);
+	memcpy(item.Data.data(), data, size);
+	_queue.push_back(std::move(item));
+
+	if(isFrame) {
+		_queuedFrames++;
+		_stats.MaxQueuedFrames = std::max(_stats.MaxQueuedFrames, _queuedFrames);
+	}
+	_queueSignal.notify_one();
+	return true;
+}
+
+bool FrameQueue::Pop(Item &item)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	_queueSignal.wait(lock, [this]() { return _stopFlag || !_queue.empty(); });
+	if(_queue.empty()) {
+		return false;
+	}
+
+	item = std::move(_queue.front());
+	_queue.pop_front();
+	return true;
+}
+
+void FrameQueue::Release(Item &item)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	if(item.IsFrame) {
+		_queuedFrames--;
+		_stats.FramesProcessed++;
+		_spaceSignal.notify_one();
+	}
+	_bufferPool.push_back(std::move(item.Data));
+}
+
+FrameQueueStats FrameQueue::GetStats()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	return _stats;
+}
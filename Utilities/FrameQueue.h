@@ -0,0 +1,52 @@
+#pragma once
+#include "stdafx.h"
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+struct FrameQueueStats
+{
+	uint32_t FramesProcessed;
+	uint32_t MaxQueuedFrames;
+	uint32_t StallCount;
+	double StallTime;
+};
+
+//Hands copies of frames (and other data, e.g audio) from the emulation thread to a recorder's encoder thread
+//Nothing is ever dropped - once the frame limit is reached, Push waits until the encoder thread catches up
+class FrameQueue
+{
+public:
+	struct Item
+	{
+		//Only frames count towards the queue's limit, other data is kept in order with the frames
+		bool IsFrame;
+		vector<uint8_t> Data;
+	};
+
+private:
+	std::mutex _lock;
+	std::condition_variable _queueSignal;
+	std::condition_variable _spaceSignal;
+	std::deque<Item> _queue;
+	vector<vector<uint8_t>> _bufferPool;
+	uint32_t _queuedFrames = 0;
+	uint32_t _maxQueuedFrames = 1;
+	bool _stopFlag = false;
+	FrameQueueStats _stats = {};
+
+public:
+	void Start(uint32_t maxQueuedFrames);
+	void Stop();
+	void Clear();
+
+	//Producer - returns false if the queue was stopped
+	bool Push(void* data, uint32_t size, bool isFrame);
+
+	//Consumer - waits for the next item, returns false once the queue is stopped and every item has been processed
+	bool Pop(Item &item);
+	//Consumer - must be called once the item has been processed, its buffer is reused by the next Push calls
+	void Release(Item &item);
+
+	FrameQueueStats GetStats();
+};
@@ -4,6 +4,7 @@
 
 GifRecorder::GifRecorder()
 {
+	_recording = false;
 	_gif.reset(new GifWriter());
 }
 
@@ -15,25 +16,50 @@ GifRecorder::~GifRecorder()
 bool GifRecorder::StartRecording(string filename, uint32_t width, uint32_t height, uint32_t bpp, uint32_t audioSampleRate, double fps)
 {
 	_outputFile = filename;
-	_recording = GifBegin(_gif.get(), filename.c_str(), width, height, 2, 8, false);
+	_width = width;
+	_height = height;
 	_frameCounter = 0;
+	_recording = GifBegin(_gif.get(), filename.c_str(), width, height, 2, 8, false);
+	if(_recording) {
+		_queue.Start(MaxQueuedFrames);
+		_encoderThread = std::thread(&GifRecorder::EncoderThread, this);
+	}
 	return _recording;
 }
 
+void GifRecorder::EncoderThread()
+{
+	FrameQueue::Item frame;
+	while(_queue.Pop(frame)) {
+		GifWriteFrame(_gif.get(), frame.Data.data(), _width, _height, 2, 8, false);
+		_queue.Release(frame);
+	}
+}
+
 void GifRecorder::StopRecording()
 {
-	if(_recording) {
-		GifEnd(_gif.get());
+	if(!_recording.exchange(false)) {
+		return;
 	}
+
+	//Every queued frame is written before the encoder thread exits
+	_queue.Stop();
+	_encoderThread.join();
+	GifEnd(_gif.get());
+	_queue.Clear();
 }
 
 void GifRecorder::AddFrame(void* frameBuffer, uint32_t width, uint32_t height, double fps)
 {
+	if(!_recording || width != _width || height != _height) {
+		return;
+	}
+
 	_frameCounter++;
 	
 	if(fps < 55 || (_frameCounter % 6) != 0) {
 		//At 60 FPS, skip 1 of every 6 frames (max FPS for GIFs is 50fps)
-		GifWriteFrame(_gif.get(), (uint8_t*)frameBuffer, width, height, 2, 8, false);
+		_queue.Push(frameBuffer, width * height * 4, true);
 	}
 }
 
@@ -49,4 +75,4 @@ bool GifRecorder::IsRecording()
 string GifRecorder::GetOutputFile()
 {
 	return _outputFile;
-}
\ No newline at end of file
+}
@@ -1,17 +1,29 @@
 #pragma once
 #include "stdafx.h"
+#include <thread>
 #include "../Utilities/IVideoRecorder.h"
+#include "../Utilities/FrameQueue.h"
 
 struct GifWriter;
 
 class GifRecorder : public IVideoRecorder
 {
 private:
+	//Frames are encoded on a worker thread - AddFrame only waits once this many frames are pending
+	static constexpr uint32_t MaxQueuedFrames = 60;
+
 	std::unique_ptr<GifWriter> _gif;
-	bool _recording = false;
+	std::thread _encoderThread;
+	FrameQueue _queue;
+
+	atomic<bool> _recording;
 	uint32_t _frameCounter = 0;
+	uint32_t _width = 0;
+	uint32_t _height = 0;
 	string _outputFile;
 
+	void EncoderThread();
+
 public:
 	GifRecorder();
 	virtual ~GifRecorder();
@@ -22,4 +34,4 @@ public:
 	void AddSound(int16_t* soundBuffer, uint32_t sampleCount, uint32_t sampleRate) override;
 	bool IsRecording() override;
 	string GetOutputFile() override;
-};
\ No newline at end of file
+};
@@ -72,7 +72,7 @@
 #define PIXEL11_90    *(dp+dpL+1) = Interp9(w[5], w[6], w[8]);
 #define PIXEL11_100   *(dp+dpL+1) = Interp10(w[5], w[6], w[8]);
 
-void HQX_CALLCONV hq2x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp, uint32_t drb, int Xres, int Yres )
+void HQX_CALLCONV hq2x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp, uint32_t drb, int Xres, int Yres, int yFirst, int yLast )
 {
     int  i, j, k;
     int  prevline, nextline;
@@ -83,6 +83,14 @@ void HQX_CALLCONV hq2x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp, uint32
     uint8_t *dRowP = (uint8_t *) dp;
     uint32_t yuv1, yuv2;
 
+    // Only process rows [yFirst, yLast) - neighboring rows are still read from the source
+    if (yFirst < 0) yFirst = 0;
+    if (yLast > Yres) yLast = Yres;
+    sRowP += (size_t)srb * yFirst;
+    dRowP += (size_t)drb * 2 * yFirst;
+    sp = (uint32_t *) sRowP;
+    dp = (uint32_t *) dRowP;
+
     //   +----+----+----+
     //   |    |    |    |
     //   | w1 | w2 | w3 |
@@ -94,7 +102,7 @@ void HQX_CALLCONV hq2x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp, uint32
     //   | w7 | w8 | w9 |
     //   +----+----+----+
 
-    for (j=0; j<Yres; j++)
+    for (j=yFirst; j<yLast; j++)
     {
         if (j>0)      prevline = -spL; else prevline = 0;
         if (j<Yres-1) nextline =  spL; else nextline = 0;
@@ -2803,8 +2811,8 @@ void HQX_CALLCONV hq2x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp, uint32
     }
 }
 
-void HQX_CALLCONV hq2x_32( uint32_t * sp, uint32_t * dp, int Xres, int Yres )
+void HQX_CALLCONV hq2x_32( uint32_t * sp, uint32_t * dp, int Xres, int Yres, int yFirst, int yLast )
 {
     uint32_t rowBytesL = Xres * 4;
-    hq2x_32_rb(sp, rowBytesL, dp, rowBytesL * 2, Xres, Yres);
+    hq2x_32_rb(sp, rowBytesL, dp, rowBytesL * 2, Xres, Yres, yFirst, yLast);
 }
@@ -164,7 +164,7 @@
 #define PIXEL33_81    *(dp+dpL+dpL+dpL+3) = Interp8(w[5], w[6]);
 #define PIXEL33_82    *(dp+dpL+dpL+dpL+3) = Interp8(w[5], w[8]);
 
-void HQX_CALLCONV hq4x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp, uint32_t drb, int Xres, int Yres )
+void HQX_CALLCONV hq4x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp, uint32_t drb, int Xres, int Yres, int yFirst, int yLast )
 {
     int  i, j, k;
     int  prevline, nextline;
@@ -175,6 +175,14 @@ void HQX_CALLCONV hq4x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp, uint32
     uint8_t *dRowP = (uint8_t *) dp;
     uint32_t yuv1, yuv2;
 
+    // Only process rows [yFirst, yLast) - neighboring rows are still read from the source
+    if (yFirst < 0) yFirst = 0;
+    if (yLast > Yres) yLast = Yres;
+    sRowP += (size_t)srb * yFirst;
+    dRowP += (size_t)drb * 4 * yFirst;
+    sp = (uint32_t *) sRowP;
+    dp = (uint32_t *) dRowP;
+
     //   +----+----+----+
     //   |    |    |    |
     //   | w1 | w2 | w3 |
@@ -186,7 +194,7 @@ void HQX_CALLCONV hq4x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp, uint32
     //   | w7 | w8 | w9 |
     //   +----+----+----+
 
-    for (j=0; j<Yres; j++)
+    for (j=yFirst; j<yLast; j++)
     {
         if (j>0)      prevline = -spL; else prevline = 0;
         if (j<Yres-1) nextline =  spL; else nextline = 0;
@@ -5227,8 +5235,8 @@ void HQX_CALLCONV hq4x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp, uint32
     }
 }
 
-void HQX_CALLCONV hq4x_32( uint32_t * sp, uint32_t * dp, int Xres, int Yres )
+void HQX_CALLCONV hq4x_32( uint32_t * sp, uint32_t * dp, int Xres, int Yres, int yFirst, int yLast )
 {
     uint32_t rowBytesL = Xres * 4;
-    hq4x_32_rb(sp, rowBytesL, dp, rowBytesL * 4, Xres, Yres);
+    hq4x_32_rb(sp, rowBytesL, dp, rowBytesL * 4, Xres, Yres, yFirst, yLast);
 }
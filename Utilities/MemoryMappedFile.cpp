@@ -0,0 +1,131 @@
+#include "stdafx.h"
+#include "MemoryMappedFile.h"
+#include "UTF8Util.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+bool MemoryMappedFile::Open(string filepath, size_t size)
+{
+	Close();
+	if(size == 0) {
+		return false;
+	}
+
+	HANDLE file = CreateFileW(utf8::utf8::decode(filepath).c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	//Mapping a range larger than the file extends it (with zeroes)
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(file, &fileSize)) {
+		CloseHandle(file);
+		return false;
+	}
+	uint64_t mappingSize = (uint64_t)fileSize.QuadPart > size ? (uint64_t)fileSize.QuadPart : size;
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, (DWORD)(mappingSize >> 32), (DWORD)mappingSize, nullptr);
+	if(!mapping) {
+		CloseHandle(file);
+		return false;
+	}
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if(!data) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	_fileHandle = file;
+	_mappingHandle = mapping;
+	_data = (uint8_t*)data;
+	_size = size;
+	return true;
+}
+
+void MemoryMappedFile::Close()
+{
+	if(_data) {
+		FlushViewOfFile(_data, 0);
+		UnmapViewOfFile(_data);
+		CloseHandle(_mappingHandle);
+		CloseHandle(_fileHandle);
+		_data = nullptr;
+		_mappingHandle = nullptr;
+		_fileHandle = nullptr;
+		_size = 0;
+	}
+}
+
+void MemoryMappedFile::Flush(bool wait)
+{
+	if(_data) {
+		FlushViewOfFile(_data, 0);
+		if(wait) {
+			FlushFileBuffers(_fileHandle);
+		}
+	}
+}
+#else
+bool MemoryMappedFile::Open(string filepath, size_t size)
+{
+	Close();
+	if(size == 0) {
+		return false;
+	}
+
+	int fd = open(filepath.c_str(), O_RDWR | O_CREAT, 0644);
+	if(fd < 0) {
+		return false;
+	}
+
+	struct stat fileInfo;
+	if(fstat(fd, &fileInfo) != 0 || ((size_t)fileInfo.st_size < size && ftruncate(fd, size) != 0)) {
+		close(fd);
+		return false;
+	}
+
+	void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(data == MAP_FAILED) {
+		close(fd);
+		return false;
+	}
+
+	_fd = fd;
+	_data = (uint8_t*)data;
+	_size = size;
+	return true;
+}
+
+void MemoryMappedFile::Close()
+{
+	if(_data) {
+		msync(_data, _size, MS_SYNC);
+		munmap(_data, _size);
+		close(_fd);
+		_data = nullptr;
+		_fd = -1;
+		_size = 0;
+	}
+}
+
+void MemoryMappedFile::Flush(bool wait)
+{
+	if(_data) {
+		msync(_data, _size, wait ? MS_SYNC : MS_ASYNC);
+	}
+}
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+#include "stdafx.h"
+
+//Maps a file in memory (read/write) - modified pages are written back to the file by the OS, even if the process crashes
+class MemoryMappedFile
+{
+private:
+	uint8_t* _data = nullptr;
+	size_t _size = 0;
+
+#ifdef _WIN32
+	void* _fileHandle = nullptr;
+	void* _mappingHandle = nullptr;
+#else
+	int _fd = -1;
+#endif
+
+public:
+	~MemoryMappedFile();
+
+	//Opens (or creates) the file and maps its first "size" bytes - the file is extended with zeroes if it is smaller
+	bool Open(string filepath, size_t size);
+	void Close();
+
+	//Writes the modified pages back to the file (only starts the write unless "wait" is true)
+	void Flush(bool wait);
+
+	bool IsOpen() { return _data != nullptr; }
+	uint8_t* GetData() { return _data; }
+	size_t GetSize() { return _size; }
+};
@@ -0,0 +1,162 @@
+#include "stdafx.h"
+#include <cmath>
+#include "PolyphaseResampler.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+	#define RESAMPLER_SSE2
+	#include <emmintrin.h>
+#endif
+
+PolyphaseResampler::PolyphaseResampler()
+{
+	BuildFilter(PassbandCutoff);
+	Reset();
+}
+
+void PolyphaseResampler::BuildFilter(double cutoff)
+{
+	constexpr double pi = 3.14159265358979323846;
+
+	//Lower cutoffs (when downsampling) need a longer filter to keep the same transition band
+	int tapCount = (int)std::ceil(BaseTapCount * PassbandCutoff / cutoff);
+	tapCount = std::min(MaxTapCount, (tapCount + 7) & ~7);
+
+	_cutoff = cutoff;
+	_coefs.resize(PhaseCount * tapCount);
+
+	double halfWidth = tapCount / 2.0;
+	for(int phase = 0; phase < PhaseCount; phase++) {
+		double fraction = (double)phase / PhaseCount;
+		double taps[MaxTapCount];
+		double sum = 0;
+		for(int i = 0; i < tapCount; i++) {
+			//Distance (in input samples) between this tap and the output sample's position
+			double t = i - (tapCount / 2 - 1) - fraction;
+			double x = pi * cutoff * t;
+			double sinc = x == 0 ? 1.0 : std::sin(x) / x;
+			double w = (t + halfWidth) / (2 * halfWidth);
+			double blackman = 0.42 - 0.5 * std::cos(2 * pi * w) + 0.08 * std::cos(4 * pi * w);
+			taps[i] = sinc * blackman;
+			sum += taps[i];
+		}
+
+		//Normalize each phase to unity gain, and distribute the rounding error to keep the DC gain exact
+		int32_t total = 0;
+		int16_t* coefs = &_coefs[phase * tapCount];
+		for(int i = 0; i < tapCount; i++) {
+			coefs[i] = (int16_t)std::lround(taps[i] / sum * (1 << CoefBits));
+			total += coefs[i];
+		}
+		coefs[tapCount / 2 - (fraction >= 0.5 ? 0 : 1)] += (int16_t)((1 << CoefBits) - total);
+	}
+
+	if(tapCount != _tapCount) {
+		_tapCount = tapCount;
+		Reset();
+	}
+}
+
+void PolyphaseResampler::Reset()
+{
+	//Pad the start with silence so the first output sample is centered on the first input sample
+	_bufferSize = _tapCount / 2 - 1;
+	_left.assign(_tapCount, 0);
+	_right.assign(_tapCount, 0);
+	_position = (uint64_t)_bufferSize << 32;
+}
+
+void PolyphaseResampler::SetSampleRates(double srcRate, double dstRate)
+{
+	double rateRatio = srcRate / dstRate;
+	if((rateRatio == 1.0) != (_rateRatio == 1.0)) {
+		//Switching to/from the passthrough mode, the history is no longer valid
+		Reset();
+	}
+
+	_rateRatio = rateRatio;
+	_step = (uint64_t)(_rateRatio * 4294967296.0);
+
+	//Only rebuild the filter when the ratio changes significantly (not for the small dynamic rate adjustments)
+	double cutoff = PassbandCutoff * std::min(1.0, dstRate / srcRate);
+	if(std::abs(cutoff - _cutoff) > _cutoff * 0.01) {
+		BuildFilter(cutoff);
+	}
+}
+
+void PolyphaseResampler::ApplyFilter(int16_t* left, int16_t* right, int16_t* coefs, int16_t* out)
+{
+	int32_t sumLeft = 0;
+	int32_t sumRight = 0;
+	int i = 0;
+#ifdef RESAMPLER_SSE2
+	__m128i accLeft = _mm_setzero_si128();
+	__m128i accRight = _mm_setzero_si128();
+	for(; i < _tapCount; i += 8) {
+		__m128i c = _mm_loadu_si128((__m128i*)(coefs + i));
+		accLeft = _mm_add_epi32(accLeft, _mm_madd_epi16(_mm_loadu_si128((__m128i*)(left + i)), c));
+		accRight = _mm_add_epi32(accRight, _mm_madd_epi16(_mm_loadu_si128((__m128i*)(right + i)), c));
+	}
+	//Horizontal sums for both channels at once (left in lanes 0/1, right in lanes 2/3)
+	__m128i acc = _mm_add_epi32(_mm_unpacklo_epi64(accLeft, accRight), _mm_unpackhi_epi64(accLeft, accRight));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+	sumLeft = _mm_cvtsi128_si32(acc);
+	sumRight = _mm_cvtsi128_si32(_mm_shuffle_epi32(acc, _MM_SHUFFLE(3, 3, 2, 2)));
+#endif
+	for(; i < _tapCount; i++) {
+		sumLeft += left[i] * coefs[i];
+		sumRight += right[i] * coefs[i];
+	}
+
+	sumLeft = (sumLeft + (1 << (CoefBits - 1))) >> CoefBits;
+	sumRight = (sumRight + (1 << (CoefBits - 1))) >> CoefBits;
+	out[0] = (int16_t)std::max(std::min(sumLeft, 32767), -32768);
+	out[1] = (int16_t)std::max(std::min(sumRight, 32767), -32768);
+}
+
+uint32_t PolyphaseResampler::Resample(int16_t* in, uint32_t inSampleCount, int16_t* out)
+{
+	if(_rateRatio == 1.0) {
+		memcpy(out, in, inSampleCount * 2 * sizeof(int16_t));
+		return inSampleCount;
+	}
+
+	if(_left.size() < _bufferSize + inSampleCount) {
+		_left.resize(_bufferSize + inSampleCount);
+		_right.resize(_bufferSize + inSampleCount);
+	}
+
+	for(uint32_t i = 0; i < inSampleCount; i++) {
+		_left[_bufferSize + i] = in[i * 2];
+		_right[_bufferSize + i] = in[i * 2 + 1];
+	}
+	_bufferSize += inSampleCount;
+	if(_bufferSize < (uint32_t)_tapCount) {
+		return 0;
+	}
+
+	//Each output sample needs (tapCount / 2) samples after its position
+	uint32_t outPos = 0;
+	uint32_t lastStart = _bufferSize - _tapCount;
+	while(true) {
+		uint32_t start = (uint32_t)(_position >> 32) - (_tapCount / 2 - 1);
+		if(start > lastStart) {
+			break;
+		}
+
+		int16_t* coefs = &_coefs[((_position >> (32 - PhaseBits)) & (PhaseCount - 1)) * _tapCount];
+		ApplyFilter(&_left[start], &_right[start], coefs, out + outPos);
+		outPos += 2;
+		_position += _step;
+	}
+
+	//Drop the samples that are no longer needed
+	uint32_t consumed = std::min((uint32_t)(_position >> 32) - (_tapCount / 2 - 1), _bufferSize - _tapCount);
+	if(consumed > 0) {
+		memmove(_left.data(), _left.data() + consumed, (_bufferSize - consumed) * sizeof(int16_t));
+		memmove(_right.data(), _right.data() + consumed, (_bufferSize - consumed) * sizeof(int16_t));
+		_bufferSize -= consumed;
+		_position -= (uint64_t)consumed << 32;
+	}
+
+	return outPos / 2;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "stdafx.h"
+
+//Stereo windowed-sinc resampler - the filter is precomputed for a fixed number of phases (fixed point),
+//and each output sample is a dot product between the input history and the nearest phase's coefficients
+class PolyphaseResampler
+{
+private:
+	static constexpr int PhaseBits = 10;
+	static constexpr int PhaseCount = 1 << PhaseBits;
+	static constexpr int CoefBits = 14;
+	static constexpr int BaseTapCount = 32;
+	static constexpr int MaxTapCount = 64;
+	static constexpr double PassbandCutoff = 0.85;
+
+	vector<int16_t> _coefs;
+	int _tapCount = 0;
+	double _cutoff = 0;
+
+	vector<int16_t> _left;
+	vector<int16_t> _right;
+	uint32_t _bufferSize = 0;
+
+	uint64_t _position = 0;
+	uint64_t _step = 1ull << 32;
+	double _rateRatio = 1.0;
+
+	void BuildFilter(double cutoff);
+	__forceinline void ApplyFilter(int16_t* left, int16_t* right, int16_t* coefs, int16_t* out);
+
+public:
+	PolyphaseResampler();
+
+	void Reset();
+
+	void SetSampleRates(double srcRate, double dstRate);
+	uint32_t Resample(int16_t* in, uint32_t inSampleCount, int16_t* out);
+};
@@ -46,16 +46,29 @@ Serializer::Serializer(istream &file, uint32_t version, bool compressed)
 	}
 }
 
+Serializer::Serializer(vector<uint8_t> &&data, uint32_t version)
+{
+	_version = version;
+
+	_block.reset(new BlockData());
+	_block->Data = std::move(data);
+	_block->Position = 0;
+	_saving = false;
+}
+
 void Serializer::EnsureCapacity(uint32_t typeSize)
 {
 	//Make sure the current block/stream is large enough to fit the next write
+	uint32_t sizeRequired = _block->Position + typeSize;
 	uint32_t oldSize = (uint32_t)_block->Data.size();
+	if(sizeRequired <= oldSize) {
+		return;
+	}
+
 	if(oldSize == 0) {
 		oldSize = typeSize * 2;
 	}
 
-	uint32_t sizeRequired = _block->Position + typeSize;
-	
 	uint32_t newSize = oldSize;
 	while(newSize < sizeRequired) {
 		newSize *= 2;
@@ -68,16 +81,38 @@ void Serializer::RecursiveStream()
 {
 }
 
-void Serializer::StreamStartBlock()
+unique_ptr<BlockData> Serializer::GetPooledBlock()
 {
-	unique_ptr<BlockData> block(new BlockData());
+	//Blocks are reused when the serializer is reset, to avoid reallocating their buffers
+	unique_ptr<BlockData> block;
+	if(_blockPool.empty()) {
+		block.reset(new BlockData());
+		if(_saving) {
+			block->Data = vector<uint8_t>(0x100);
+		}
+	} else {
+		block = std::move(_blockPool.back());
+		_blockPool.pop_back();
+	}
 	block->Position = 0;
+	return block;
+}
+
+void Serializer::StreamStartBlock()
+{
+	unique_ptr<BlockData> block = GetPooledBlock();
 
 	if(!_saving) {
-		VectorInfo<uint8_t> vectorInfo = { &block->Data };
-		InternalStream(vectorInfo);
-	} else {
-		block->Data = vector<uint8_t>(0x100);
+		uint32_t size = 0;
+		StreamElement<uint32_t>(size);
+		if(size > 0xFFFFFF) {
+			throw std::runtime_error("Invalid save state");
+		}
+
+		size = std::min(size, (uint32_t)_block->Data.size() - _block->Position);
+		block->Data.resize(size);
+		memcpy(block->Data.data(), _block->Data.data() + _block->Position, size);
+		_block->Position += size;
 	}
 
 	_blocks.push_back(std::move(_block));
@@ -99,6 +134,39 @@ void Serializer::StreamEndBlock()
 		ArrayInfo<uint8_t> arrayInfo { block->Data.data(), block->Position };
 		InternalStream(arrayInfo);
 	}
+
+	_blockPool.push_back(std::move(block));
+}
+
+void Serializer::ReleaseBlocks()
+{
+	//Return any block left open (e.g by an exception) to the pool
+	if(!_blocks.empty()) {
+		_blockPool.push_back(std::move(_block));
+		_block = std::move(_blocks.front());
+		for(size_t i = 1; i < _blocks.size(); i++) {
+			_blockPool.push_back(std::move(_blocks[i]));
+		}
+		_blocks.clear();
+	}
+}
+
+void Serializer::ResetForSave()
+{
+	ReleaseBlocks();
+	_saving = true;
+	_block->Position = 0;
+}
+
+void Serializer::ResetForLoad()
+{
+	ReleaseBlocks();
+	if(_saving) {
+		//Only keep the data that was written (the buffer's capacity is kept)
+		_block->Data.resize(_block->Position);
+	}
+	_saving = false;
+	_block->Position = 0;
 }
 
 void Serializer::Save(ostream& file, int compressionLevel)
@@ -35,6 +35,7 @@ class Serializer
 {
 private:
 	vector<unique_ptr<BlockData>> _blocks;	
+	vector<unique_ptr<BlockData>> _blockPool;
 	unique_ptr<BlockData> _block;
 
 	uint32_t _version = 0;
@@ -54,16 +55,27 @@ private:
 
 	template<typename T, typename... T2> void RecursiveStream(T &value, T2&... args);
 
+	unique_ptr<BlockData> GetPooledBlock();
+	void ReleaseBlocks();
 	void StreamStartBlock();
 	void StreamEndBlock();
 
 public:
 	Serializer(uint32_t version);
 	Serializer(istream &file, uint32_t version, bool compressed = true);
+	Serializer(vector<uint8_t> &&data, uint32_t version);
 
 	uint32_t GetVersion() { return _version; }
 	bool IsSaving() { return _saving; }
 
+	//Raw (uncompressed) access to the data written so far, used to avoid going through a stream
+	uint8_t* GetData() { return _block->Data.data(); }
+	uint32_t GetSize() { return _block->Position; }
+
+	//Resets the serializer to save/load again, while keeping all of its buffers allocated (used by run-ahead)
+	void ResetForSave();
+	void ResetForLoad();
+
 	template<typename... T> void Stream(T&... args);
 	template<typename T> void StreamArray(T *array, uint32_t size);
 	template<typename T> void StreamVector(vector<T> &list);
@@ -81,13 +93,9 @@ template<typename T>
 void Serializer::StreamElement(T &value, T defaultValue)
 {
 	if(_saving) {
-		uint8_t* bytes = (uint8_t*)&value;
-		int typeSize = sizeof(T);
-
-		EnsureCapacity(typeSize);
-		for(int i = 0; i < typeSize; i++) {
-			_block->Data[_block->Position++] = bytes[i];
-		}
+		EnsureCapacity(sizeof(T));
+		memcpy(_block->Data.data() + _block->Position, &value, sizeof(T));
+		_block->Position += sizeof(T);
 	} else {
 		if(_block->Position + sizeof(T) <= _block->Data.size()) {
 			memcpy(&value, _block->Data.data() + _block->Position, sizeof(T));
@@ -138,10 +146,23 @@ void Serializer::InternalStream(VectorInfo<T> &info)
 	}
 
 	//Load the number of elements requested
-	T* pointer = vector->data();
-	for(uint32_t i = 0; i < count; i++) {
-		StreamElement<T>(*pointer);
-		pointer++;
+	if(_saving) {
+		EnsureCapacity(count * sizeof(T));
+	}
+
+	if(_block->Position + count * sizeof(T) <= _block->Data.size()) {
+		if(_saving) {
+			memcpy(_block->Data.data() + _block->Position, vector->data(), count * sizeof(T));
+		} else {
+			memcpy(vector->data(), _block->Data.data() + _block->Position, count * sizeof(T));
+		}
+		_block->Position += count * sizeof(T);
+	} else {
+		T* pointer = vector->data();
+		for(uint32_t i = 0; i < count; i++) {
+			StreamElement<T>(*pointer);
+			pointer++;
+		}
 	}
 }
 
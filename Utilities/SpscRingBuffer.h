@@ -0,0 +1,108 @@
+#pragma once
+#include "stdafx.h"
+
+//Lock-free ring buffer with a single producer thread and a single consumer thread
+//The capacity is rounded up to a power of 2 (one slot is kept empty to tell a full buffer from an empty one)
+template<typename T>
+class SpscRingBuffer
+{
+private:
+	vector<T> _buffer;
+	uint32_t _mask = 0;
+
+	std::atomic<uint32_t> _readPos;
+	std::atomic<uint32_t> _writePos;
+
+public:
+	SpscRingBuffer(uint32_t capacity = 0)
+	{
+		_readPos = 0;
+		_writePos = 0;
+		SetCapacity(capacity);
+	}
+
+	//Not thread-safe, must only be called while neither thread is using the buffer
+	void SetCapacity(uint32_t capacity)
+	{
+		uint32_t size = 1;
+		while(size < capacity + 1) {
+			size <<= 1;
+		}
+		_buffer = vector<T>(size);
+		_mask = size - 1;
+		Clear();
+	}
+
+	//Not thread-safe, must only be called while neither thread is using the buffer
+	void Clear()
+	{
+		_readPos = 0;
+		_writePos = 0;
+	}
+
+	uint32_t GetCapacity()
+	{
+		return _mask;
+	}
+
+	uint32_t GetReadCount()
+	{
+		return (_writePos.load(std::memory_order_acquire) - _readPos.load(std::memory_order_acquire)) & _mask;
+	}
+
+	uint32_t GetWriteSpace()
+	{
+		return _mask - GetReadCount();
+	}
+
+	//Producer
+	bool Push(const T &value)
+	{
+		uint32_t writePos = _writePos.load(std::memory_order_relaxed);
+		uint32_t nextPos = (writePos + 1) & _mask;
+		if(nextPos == _readPos.load(std::memory_order_acquire)) {
+			return false;
+		}
+		_buffer[writePos] = value;
+		_writePos.store(nextPos, std::memory_order_release);
+		return true;
+	}
+
+	//Producer - writes as many values as possible, returns the number of values written
+	uint32_t Write(const T *values, uint32_t count)
+	{
+		uint32_t writePos = _writePos.load(std::memory_order_relaxed);
+		uint32_t space = (_readPos.load(std::memory_order_acquire) - writePos - 1) & _mask;
+		count = std::min(count, space);
+		for(uint32_t i = 0; i < count; i++) {
+			_buffer[(writePos + i) & _mask] = values[i];
+		}
+		_writePos.store((writePos + count) & _mask, std::memory_order_release);
+		return count;
+	}
+
+	//Consumer
+	bool Pop(T &value)
+	{
+		uint32_t readPos = _readPos.load(std::memory_order_relaxed);
+		if(readPos == _writePos.load(std::memory_order_acquire)) {
+			return false;
+		}
+		value = _buffer[readPos];
+		_readPos.store((readPos + 1) & _mask, std::memory_order_release);
+		return true;
+	}
+
+	//Consumer - reads up to "count" values, returns the number of values read
+	uint32_t Read(T *values, uint32_t count)
+	{
+		uint32_t readPos = _readPos.load(std::memory_order_relaxed);
+		uint32_t available = (_writePos.load(std::memory_order_acquire) - readPos) & _mask;
+		count = std::min(count, available);
+		for(uint32_t i = 0; i < count; i++) {
+			values[i] = _buffer[(readPos + i) & _mask];
+		}
+		_readPos.store((readPos + count) & _mask, std::memory_order_release);
+		return count;
+	}
+};
@@ -0,0 +1,90 @@
+#include "stdafx.h"
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+	_nextTask = 0;
+	for(uint32_t i = 1; i < threadCount; i++) {
+		_threads.push_back(std::thread(&ThreadPool::WorkerThread, this));
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_startSignal.notify_all();
+
+	for(std::thread &thread : _threads) {
+		thread.join();
+	}
+}
+
+uint32_t ThreadPool::GetThreadCount()
+{
+	return (uint32_t)_threads.size() + 1;
+}
+
+uint32_t ThreadPool::GetDefaultThreadCount(uint32_t maxThreads)
+{
+	uint32_t cpuCount = std::thread::hardware_concurrency();
+	return std::max<uint32_t>(1, std::min<uint32_t>(cpuCount, maxThreads));
+}
+
+void ThreadPool::RunTasks()
+{
+	uint32_t index;
+	while((index = _nextTask++) < _taskCount) {
+		(*_task)(index);
+	}
+}
+
+void ThreadPool::WorkerThread()
+{
+	uint32_t generation = 0;
+	while(true) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_startSignal.wait(lock, [&] { return _stop || _generation != generation; });
+			if(_stop) {
+				return;
+			}
+			generation = _generation;
+		}
+
+		RunTasks();
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		if(--_activeWorkers == 0) {
+			_doneSignal.notify_one();
+		}
+	}
+}
+
+void ThreadPool::Run(uint32_t taskCount, const std::function<void(uint32_t)> &task)
+{
+	if(_threads.empty() || taskCount <= 1) {
+		for(uint32_t i = 0; i < taskCount; i++) {
+			task(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_task = &task;
+		_taskCount = taskCount;
+		_nextTask = 0;
+		_activeWorkers = (uint32_t)_threads.size();
+		_generation++;
+	}
+	_startSignal.notify_all();
+
+	RunTasks();
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_doneSignal.wait(lock, [&] { return _activeWorkers == 0; });
+	_task = nullptr;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "stdafx.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+//Fixed-size pool of worker threads used to split work into independent tasks (fork/join)
+class ThreadPool
+{
+private:
+	vector<std::thread> _threads;
+	std::mutex _mutex;
+	std::condition_variable _startSignal;
+	std::condition_variable _doneSignal;
+
+	const std::function<void(uint32_t)>* _task = nullptr;
+	uint32_t _taskCount = 0;
+	std::atomic<uint32_t> _nextTask;
+	uint32_t _activeWorkers = 0;
+	uint32_t _generation = 0;
+	bool _stop = false;
+
+	void WorkerThread();
+	void RunTasks();
+
+public:
+	//threadCount includes the calling thread (e.g a count of 1 runs all tasks on the caller)
+	ThreadPool(uint32_t threadCount);
+	~ThreadPool();
+
+	uint32_t GetThreadCount();
+
+	//Runs task(0) to task(taskCount - 1) on the pool (and the calling thread), and returns once all tasks are done
+	void Run(uint32_t taskCount, const std::function<void(uint32_t)> &task);
+
+	static uint32_t GetDefaultThreadCount(uint32_t maxThreads);
+};
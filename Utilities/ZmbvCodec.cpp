@@ -28,6 +28,11 @@
 #include "miniz.h"
 #include "ZmbvCodec.h"
 
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+	#define ZMBV_SSE2
+	#include <emmintrin.h>
+#endif
+
 #define DBZV_VERSION_HIGH 0
 #define DBZV_VERSION_LOW 1
 
@@ -79,14 +84,15 @@ bool ZmbvCodec::SetupBuffers(zmbv_format_t _format, int blockwidth, int blockhei
 	buf2 = new unsigned char[bufsize];
 	work = new unsigned char[bufsize];
 
-	int xblocks = (width/blockwidth);
+	xblocks = (width/blockwidth);
 	int xleft = width % blockwidth;
 	if (xleft) xblocks++;
-	int yblocks = (height/blockheight);
+	yblocks = (height/blockheight);
 	int yleft = height % blockheight;
 	if (yleft) yblocks++;
 	blockcount=yblocks*xblocks;
 	blocks=new FrameBlock[blockcount];
+	blockVectors.resize(blockcount);
 
 	if (!buf1 || !buf2 || !work || !blocks) {
 		FreeBuffers();
@@ -141,6 +147,59 @@ void ZmbvCodec::CreateVectorTable(void) {
 	}
 }
 
+//Counts the pixels that differ (ignoring the alpha channel) between 2 rows
+template<class P>
+static INLINE int CountChangedPixels(P * pold, P * pnew, int count) {
+	int ret=0;
+	for (int x=0;x<count;x++) {
+		int test=0-((pold[x]-pnew[x])&0x00ffffff);
+		ret-=(test>>31);
+	}
+	return ret;
+}
+
+template<class P>
+static INLINE void XorPixels(unsigned char * dest, P * pold, P * pnew, int count) {
+	for (int x=0;x<count;x++) {
+		*((P*)dest)=pnew[x] ^ pold[x];
+		dest+=sizeof(P);
+	}
+}
+
+#ifdef ZMBV_SSE2
+template<>
+INLINE int CountChangedPixels<int32_t>(int32_t * pold, int32_t * pnew, int count) {
+	__m128i mask = _mm_set1_epi32(0x00ffffff);
+	__m128i zero = _mm_setzero_si128();
+	__m128i unchanged = _mm_setzero_si128();
+	int x=0;
+	for (;x+4<=count;x+=4) {
+		__m128i diff = _mm_xor_si128(_mm_loadu_si128((__m128i*)(pold+x)), _mm_loadu_si128((__m128i*)(pnew+x)));
+		//cmpeq gives -1 for each unchanged pixel
+		unchanged = _mm_add_epi32(unchanged, _mm_cmpeq_epi32(_mm_and_si128(diff, mask), zero));
+	}
+	int32_t lanes[4];
+	_mm_storeu_si128((__m128i*)lanes, unchanged);
+	int ret = x + lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	for (;x<count;x++) {
+		ret += ((pold[x] ^ pnew[x]) & 0x00ffffff) ? 1 : 0;
+	}
+	return ret;
+}
+
+template<>
+INLINE void XorPixels<int32_t>(unsigned char * dest, int32_t * pold, int32_t * pnew, int count) {
+	int x=0;
+	for (;x+4<=count;x+=4) {
+		__m128i value = _mm_xor_si128(_mm_loadu_si128((__m128i*)(pold+x)), _mm_loadu_si128((__m128i*)(pnew+x)));
+		_mm_storeu_si128((__m128i*)(dest+x*4), value);
+	}
+	for (;x<count;x++) {
+		*((int32_t*)(dest+x*4))=pnew[x] ^ pold[x];
+	}
+}
+#endif
+
 template<class P>
 INLINE int ZmbvCodec::PossibleBlock(int vx,int vy,FrameBlock * block) {
 	int ret=0;
@@ -163,10 +222,7 @@ INLINE int ZmbvCodec::CompareBlock(int vx,int vy,FrameBlock * block) {
 	P * pold=((P*)oldframe)+block->start+(vy*pitch)+vx;
 	P * pnew=((P*)newframe)+block->start;;	
 	for (int y=0;y<block->dy;y++) {
-		for (int x=0;x<block->dx;x++) {
-			int test=0-((pold[x]-pnew[x])&0x00ffffff);
-			ret-=(test>>31);
-		}
+		ret+=CountChangedPixels<P>(pold, pnew, block->dx);
 		pold+=pitch;
 		pnew+=pitch;
 	}
@@ -174,51 +230,75 @@ INLINE int ZmbvCodec::CompareBlock(int vx,int vy,FrameBlock * block) {
 }
 
 template<class P>
-INLINE void ZmbvCodec::AddXorBlock(int vx,int vy,FrameBlock * block) {
+INLINE void ZmbvCodec::AddXorBlock(int vx,int vy,FrameBlock * block,unsigned char * dest) {
 	P * pold=((P*)oldframe)+block->start+(vy*pitch)+vx;
 	P * pnew=((P*)newframe)+block->start;
 	for (int y=0;y<block->dy;y++) {
-		for (int x=0;x<block->dx;x++) {
-			*((P*)&work[workUsed])=pnew[x] ^ pold[x];
-			workUsed+=sizeof(P);
-		}
+		XorPixels<P>(dest, pold, pnew, block->dx);
+		dest+=block->dx*sizeof(P);
 		pold+=pitch;
 		pnew+=pitch;
 	}
 }
 
+template<class P>
+void ZmbvCodec::FindBlockVector(FrameBlock * block,BlockVector & blockVector) {
+	int bestvx = 0;
+	int bestvy = 0;
+	int bestchange=CompareBlock<P>(0,0, block);
+	int possibles=64;
+	for (int v=0;v<VectorCount && possibles;v++) {
+		if (bestchange<4) break;
+		int vx = VectorTable[v].x;
+		int vy = VectorTable[v].y;
+		if (PossibleBlock<P>(vx, vy, block) < 4) {
+			possibles--;
+			int testchange=CompareBlock<P>(vx,vy, block);
+			if (testchange<bestchange) {
+				bestchange=testchange;
+				bestvx = vx;
+				bestvy = vy;
+			}
+		}
+	}
+	blockVector.x = bestvx;
+	blockVector.y = bestvy;
+	blockVector.changed = bestchange;
+}
+
 template<class P>
 void ZmbvCodec::AddXorFrame(void) {
 	signed char * vectors=(signed char*)&work[workUsed];
 	/* Align the following xor data on 4 byte boundary*/
 	workUsed=(workUsed + blockcount*2 +3) & ~3;
-	for (int b=0;b<blockcount;b++) {
-		FrameBlock * block=&blocks[b];
-		int bestvx = 0;
-		int bestvy = 0;
-		int bestchange=CompareBlock<P>(0,0, block);
-		int possibles=64;
-		for (int v=0;v<VectorCount && possibles;v++) {
-			if (bestchange<4) break;
-			int vx = VectorTable[v].x;
-			int vy = VectorTable[v].y;
-			if (PossibleBlock<P>(vx, vy, block) < 4) {
-				possibles--;
-				int testchange=CompareBlock<P>(vx,vy, block);
-				if (testchange<bestchange) {
-					bestchange=testchange;
-					bestvx = vx;
-					bestvy = vy;
-				}
-			}
+
+	//Each block only reads the old/new frames, so the motion search for each row of blocks can run in parallel
+	_threadPool->Run(yblocks, [this](uint32_t row) {
+		for (int b=row*xblocks;b<(int)(row+1)*xblocks;b++) {
+			FindBlockVector<P>(&blocks[b], blockVectors[b]);
 		}
-		vectors[b*2+0]=(bestvx << 1);
-		vectors[b*2+1]=(bestvy << 1);
-		if (bestchange) {
+	});
+
+	for (int b=0;b<blockcount;b++) {
+		BlockVector & blockVector=blockVectors[b];
+		vectors[b*2+0]=(blockVector.x << 1);
+		vectors[b*2+1]=(blockVector.y << 1);
+		if (blockVector.changed) {
 			vectors[b*2+0]|=1;
-			AddXorBlock<P>(bestvx, bestvy, block);
+			blockVector.offset=workUsed;
+			workUsed+=blocks[b].dx*blocks[b].dy*sizeof(P);
 		}
 	}
+
+	//The xor data for each block has a known position in the work buffer, fill it in parallel too
+	_threadPool->Run(yblocks, [this](uint32_t row) {
+		for (int b=row*xblocks;b<(int)(row+1)*xblocks;b++) {
+			BlockVector & blockVector=blockVectors[b];
+			if (blockVector.changed) {
+				AddXorBlock<P>(blockVector.x, blockVector.y, &blocks[b], &work[blockVector.offset]);
+			}
+		}
+	});
 }
 
 bool ZmbvCodec::SetupCompress( int _width, int _height, uint32_t compressionLevel ) {
@@ -229,6 +309,10 @@ bool ZmbvCodec::SetupCompress( int _width, int _height, uint32_t compressionLeve
 	if (deflateInit (&zstream, compressionLevel) != Z_OK)
 		return false;
 
+	if(!_threadPool) {
+		_threadPool.reset(new ThreadPool(ThreadPool::GetDefaultThreadCount(4)));
+	}
+
 	return true;
 }
 
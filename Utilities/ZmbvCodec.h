@@ -22,6 +22,7 @@
 #pragma once
 
 #include "BaseCodec.h"
+#include "ThreadPool.h"
 #include "miniz.h"
 
 #ifdef _MSC_VER
@@ -53,6 +54,11 @@ private:
 		int x = 0,y = 0;
 		int slot = 0;
 	};
+	struct BlockVector {
+		int x = 0,y = 0;
+		int changed = 0;
+		int offset = 0;
+	};
 	struct KeyframeHeader {
 		unsigned char high_version = 0;
 		unsigned char low_version = 0;
@@ -76,7 +82,11 @@ private:
 	int bufsize = 0;
 
 	int blockcount = 0; 
+	int xblocks = 0, yblocks = 0;
 	FrameBlock * blocks = nullptr;
+	vector<BlockVector> blockVectors;
+
+	unique_ptr<ThreadPool> _threadPool;
 
 	int workUsed = 0, workPos = 0;
 
@@ -99,7 +109,8 @@ private:
 	template<class P> void AddXorFrame(void);
 	template<class P> INLINE int PossibleBlock(int vx,int vy,FrameBlock * block);
 	template<class P> INLINE int CompareBlock(int vx,int vy,FrameBlock * block);
-	template<class P> INLINE void AddXorBlock(int vx,int vy,FrameBlock * block);
+	template<class P> INLINE void AddXorBlock(int vx,int vy,FrameBlock * block,unsigned char * dest);
+	template<class P> void FindBlockVector(FrameBlock * block,BlockVector & blockVector);
 
 	int NeededSize(int _width, int _height, zmbv_format_t _format);
 
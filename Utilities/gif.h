@@ -488,9 +488,50 @@ void GifDitherImage( const uint8_t* lastFrame, const uint8_t* nextFrame, uint8_t
     GIF_TEMP_FREE(quantPixels);
 }
 
+// Caches the k-d tree results for the current palette, indexed by the color's 15-bit RGB value.
+// Frames that only contain 15-bit colors (e.g SNES output without filters) never collide, so
+// each distinct color is searched once per frame - other colors still get exact results, they just
+// miss the cache more often.
+struct GifColorCache
+{
+    uint32_t generation;
+    uint32_t entryGeneration[0x8000];
+    uint32_t color[0x8000];
+    uint8_t index[0x8000];
+};
+
+void GifResetColorCache(GifColorCache* cache)
+{
+    cache->generation++;
+    if(cache->generation == 0)
+    {
+        memset(cache->entryGeneration, 0, sizeof(cache->entryGeneration));
+        cache->generation = 1;
+    }
+}
+
+int GifGetCachedPaletteColor(GifPalette* pPal, GifColorCache* cache, int r, int g, int b)
+{
+    uint32_t key = ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+    uint32_t color = (r << 16) | (g << 8) | b;
+    if(cache->entryGeneration[key] == cache->generation && cache->color[key] == color)
+        return cache->index[key];
+
+    int32_t bestDiff = 1000000;
+    int32_t bestInd = 1;
+    GifGetClosestPaletteColor(pPal, r, g, b, bestInd, bestDiff);
+
+    cache->entryGeneration[key] = cache->generation;
+    cache->color[key] = color;
+    cache->index[key] = (uint8_t)bestInd;
+    return bestInd;
+}
+
 // Picks palette colors for the image using simple thresholding, no dithering
-void GifThresholdImage( const uint8_t* lastFrame, const uint8_t* nextFrame, uint8_t* outFrame, uint32_t width, uint32_t height, GifPalette* pPal )
+void GifThresholdImage( const uint8_t* lastFrame, const uint8_t* nextFrame, uint8_t* outFrame, uint32_t width, uint32_t height, GifPalette* pPal, GifColorCache* cache )
 {
+    GifResetColorCache(cache);
+
     uint32_t numPixels = width*height;
     for( uint32_t ii=0; ii<numPixels; ++ii )
     {
@@ -509,9 +550,7 @@ void GifThresholdImage( const uint8_t* lastFrame, const uint8_t* nextFrame, uint
         else
         {
             // palettize the pixel
-            int32_t bestDiff = 1000000;
-            int32_t bestInd = 1;
-            GifGetClosestPaletteColor(pPal, nextFrame[0], nextFrame[1], nextFrame[2], bestInd, bestDiff);
+            int32_t bestInd = GifGetCachedPaletteColor(pPal, cache, nextFrame[0], nextFrame[1], nextFrame[2]);
 
             // Write the resulting color to the output buffer
             outFrame[0] = pPal->r[bestInd];
@@ -729,6 +768,7 @@ struct GifWriter
 {
     FILE* f;
     uint8_t* oldImage;
+    GifColorCache* colorCache;
     bool firstFrame;
 };
 
@@ -750,6 +790,8 @@ bool GifBegin( GifWriter* writer, const char* filename, uint32_t width, uint32_t
 
     // allocate
     writer->oldImage = (uint8_t*)GIF_MALLOC(width*height*4);
+    writer->colorCache = (GifColorCache*)GIF_MALLOC(sizeof(GifColorCache));
+    memset(writer->colorCache, 0, sizeof(GifColorCache));
 
     fputs("GIF89a", writer->f);
 
@@ -809,7 +851,7 @@ bool GifWriteFrame( GifWriter* writer, const uint8_t* image, uint32_t width, uin
     if(dither)
         GifDitherImage(oldImage, image, writer->oldImage, width, height, &pal);
     else
-        GifThresholdImage(oldImage, image, writer->oldImage, width, height, &pal);
+        GifThresholdImage(oldImage, image, writer->oldImage, width, height, &pal, writer->colorCache);
 
     GifWriteLzwImage(writer->f, writer->oldImage, 0, 0, width, height, delay, &pal);
 
@@ -826,9 +868,11 @@ bool GifEnd( GifWriter* writer )
     fputc(0x3b, writer->f); // end of file
     fclose(writer->f);
     GIF_FREE(writer->oldImage);
+    GIF_FREE(writer->colorCache);
 
     writer->f = NULL;
     writer->oldImage = NULL;
+    writer->colorCache = NULL;
 
     return true;
 }